@@ -38,6 +38,14 @@ namespace vast::cg {
     //
     // composable builder state
     //
+    // Each step stores its bound arguments and the previous step by value in a
+    // closure on the stack, nothing is allocated. Bound values are mostly
+    // pointers, attributes and locations, so the copies are free, other values
+    // are moved along the chain. The chain is invoked at most once by freeze,
+    // hence every step hands its values over to the next one:
+    //
+    //   make_operation< op_t >().bind(loc).bind(builder).freeze();
+    //
     template< typename result_type, typename bind_type >
     struct compose_state_t;
 
@@ -61,24 +69,28 @@ namespace vast::cg {
 
         template< typename ...args_t >
         constexpr inline auto bind(args_t &&...args) && {
-            auto binded = [... args = std::forward< args_t >(args), binder = std::move(binder)] (auto &&...rest) {
+            auto binded = [
+                ...args = std::forward< args_t >(args), binder = std::move(binder)
+            ] (auto &&...rest) mutable {
                 if (!valid(args...)) {
                     return result_type{};
                 }
-                return binder(args..., std::forward< decltype(rest) >(rest)...);
+                return binder(std::move(args)..., std::forward< decltype(rest) >(rest)...);
             };
             return compose_state_t< result_type, decltype(binded) >(std::move(binded));
         }
 
         template< typename arg_t >
         constexpr inline auto bind_if(bool cond, arg_t &&arg) && {
-            auto binded = [cond, arg = std::forward< arg_t >(arg), binder = std::move(binder)] (auto &&...args) {
+            auto binded = [
+                cond, arg = std::forward< arg_t >(arg), binder = std::move(binder)
+            ] (auto &&...args) mutable {
                 if (cond) {
                     if (!valid(arg)) {
                         return result_type{};
                     }
 
-                    return binder(arg, std::forward< decltype(args) >(args)...);
+                    return binder(std::move(arg), std::forward< decltype(args) >(args)...);
                 }
 
                 return binder(std::forward< decltype(args) >(args)...);
@@ -88,20 +100,22 @@ namespace vast::cg {
 
         template< typename arg_t >
         constexpr inline auto bind_region_if(bool cond, arg_t &&arg) && {
-            auto binded = [cond, arg = std::forward< arg_t >(arg), binder = std::move(binder)] (auto &&...args) {
+            auto binded = [
+                cond, arg = std::forward< arg_t >(arg), binder = std::move(binder)
+            ] (auto &&...args) mutable {
                 if (cond) {
                     if (!valid(arg)) {
                         return result_type{};
                     }
 
-                    return binder(arg, std::forward< decltype(args) >(args)...);
+                    return binder(std::move(arg), std::forward< decltype(args) >(args)...);
                 }
                 return binder(std::nullopt, std::forward< decltype(args) >(args)...);
             };
             return compose_state_t< result_type, decltype(binded) >(std::move(binded));
         }
 
-        auto freeze() { return binder(); }
+        auto freeze() && { return binder(); }
 
         bind_type binder;
     };
@@ -8,7 +8,6 @@ VAST_RELAX_WARNINGS
 #include <clang/AST/GlobalDecl.h>
 #include <clang/AST/ASTContext.h>
 #include <clang/Basic/SourceManager.h>
-#include <llvm/ADT/ScopedHashTable.h>
 #include <llvm/ADT/SmallPtrSet.h>
 #include <llvm/IR/GlobalValue.h>
 #include <mlir/IR/MLIRContext.h>
@@ -98,26 +97,9 @@ namespace vast::cg
         // It owns the strings that mangled_name_ref uses
         CodeGenMangler mangler;
 
-        using var_table = scoped_table< const clang::VarDecl *, Value >;
-        var_table vars;
-
-        using TypeDefTable = scoped_table< const clang::TypedefDecl *, hl::TypeDefOp >;
-        TypeDefTable typedefs;
-
-        using TypeDeclTable = scoped_table< const clang::TypeDecl *, hl::TypeDeclOp >;
-        TypeDeclTable typedecls;
-
-        using FuncDeclTable = scoped_table< mangled_name_ref, hl::FuncOp >;
-        FuncDeclTable funcdecls;
-
-        using EnumDecls = scoped_table< const clang::EnumDecl *, hl::EnumDeclOp >;
-        EnumDecls enumdecls;
-
-        using EnumConstants = scoped_table< const clang::EnumConstantDecl *, hl::EnumConstantOp >;
-        EnumConstants enumconsts;
-
-        using LabelTable = scoped_table< const clang::LabelDecl*, hl::LabelDeclOp >;
-        LabelTable labels;
+        // Variables, labels, typedefs, type and enum declarations, enum
+        // constants and functions.
+        symbol_table symbols;
 
         size_t anonymous_count = 0;
         llvm::DenseMap< const clang::NamedDecl *, std::string > tag_names;
@@ -138,7 +120,8 @@ namespace vast::cg
         // for emission and therefore should only be output if they are actually
         // used. If a decl is in this, then it is known to have not been referenced
         // yet.
-        std::map< mangled_name_ref, clang::GlobalDecl > deferred_decls;
+        using deferred_decls_map = llvm::DenseMap< mangled_name_ref, clang::GlobalDecl >;
+        deferred_decls_map deferred_decls;
 
         // A queue of (optional) vtables to consider emitting.
         std::vector< const clang::CXXRecordDecl * > deferred_vtables;
@@ -229,59 +212,74 @@ namespace vast::cg
 
         auto error(llvm::Twine msg) { return mod->emitError(msg); }
 
-        template< typename Table, typename Token, typename ValueType = typename Table::value_type >
-        ValueType symbol(Table &table, const Token &token, llvm::Twine msg, bool with_error = true) {
-            if (auto val = table.lookup(token))
-                return val;
-            if (with_error)
-                error(msg);
-            return nullptr;
-        }
+        // Mangled names are interned by the mangler, so their data identify
+        // the functions in the symbol table.
+        static const void *function_key(mangled_name_ref mangled) { return mangled.name.data(); }
 
         hl::FuncOp lookup_function(mangled_name_ref mangled, bool with_error = true) {
-            return symbol(funcdecls, mangled, "undeclared function '" + mangled.name + "'", with_error);
+            if (auto fn = symbols.lookup< hl::FuncOp >(symbol_kind::function, function_key(mangled))) {
+                return fn;
+            }
+            if (with_error) {
+                error("undeclared function '" + mangled.name + "'");
+            }
+            return {};
+        }
+
+        mlir_value lookup(const clang::VarDecl *decl) const {
+            return symbols.lookup< mlir_value >(symbol_kind::var, decl);
+        }
+
+        hl::EnumDeclOp lookup(const clang::EnumDecl *decl) const {
+            return symbols.lookup< hl::EnumDeclOp >(symbol_kind::enum_decl, decl);
+        }
+
+        hl::EnumConstantOp lookup(const clang::EnumConstantDecl *decl) const {
+            return symbols.lookup< hl::EnumConstantOp >(symbol_kind::enum_constant, decl);
         }
 
         hl::FuncOp declare(mangled_name_ref mangled, auto vast_decl_builder) {
-            return declare< hl::FuncOp >(funcdecls, mangled, vast_decl_builder, mangled.name);
+            return declare< hl::FuncOp >(
+                symbol_kind::function, function_key(mangled), vast_decl_builder, mangled.name
+            );
         }
 
         mlir_value declare(const clang::VarDecl *decl, mlir_value vast_value) {
-            return declare< mlir_value >(vars, decl, [vast_value] { return vast_value; }, decl->getName());
+            return declare< mlir_value >(symbol_kind::var, decl, [vast_value] { return vast_value; }, decl->getName());
         }
 
         mlir_value declare(const clang::VarDecl *decl, auto vast_decl_builder) {
-            return declare< mlir_value >(vars, decl, vast_decl_builder, decl->getName());
+            return declare< mlir_value >(symbol_kind::var, decl, vast_decl_builder, decl->getName());
         }
 
         hl::LabelDeclOp declare(const clang::LabelDecl *decl, auto vast_decl_builder) {
-            return declare< hl::LabelDeclOp >(labels, decl, vast_decl_builder, decl->getName());
+            return declare< hl::LabelDeclOp >(symbol_kind::label, decl, vast_decl_builder, decl->getName());
         }
 
         hl::TypeDefOp declare(const clang::TypedefDecl *decl, auto vast_decl_builder) {
-            return declare< hl::TypeDefOp >(typedefs, decl, vast_decl_builder, decl->getName());
+            return declare< hl::TypeDefOp >(symbol_kind::type_def, decl, vast_decl_builder, decl->getName());
         }
 
         hl::TypeDeclOp declare(const clang::TypeDecl *decl, auto vast_decl_builder) {
-            return declare< hl::TypeDeclOp >(typedecls, decl, vast_decl_builder, decl->getName());
+            return declare< hl::TypeDeclOp >(symbol_kind::type_decl, decl, vast_decl_builder, decl->getName());
         }
 
         hl::EnumDeclOp declare(const clang::EnumDecl *decl, auto vast_decl_builder) {
-            return declare< hl::EnumDeclOp >(enumdecls, decl, vast_decl_builder, decl->getName());
+            return declare< hl::EnumDeclOp >(symbol_kind::enum_decl, decl, vast_decl_builder, decl->getName());
         }
 
         hl::EnumConstantOp declare(const clang::EnumConstantDecl *decl, auto vast_decl_builder) {
-            return declare< hl::EnumConstantOp >(enumconsts, decl, vast_decl_builder, decl->getName());
+            return declare< hl::EnumConstantOp >(symbol_kind::enum_constant, decl, vast_decl_builder, decl->getName());
         }
 
-        template< typename SymbolValue, typename Key >
-        SymbolValue declare(auto &table, Key &&key, auto vast_decl_builder, string_ref name) {
-            if (auto con = table.lookup(key)) {
+        template< typename SymbolValue >
+        SymbolValue declare(symbol_kind kind, const void *key, auto vast_decl_builder, string_ref name) {
+            if (auto con = symbols.lookup< SymbolValue >(kind, key)) {
                 return con;
             }
 
-            auto value = vast_decl_builder();
-            if (failed(table.declare(std::forward< Key >(key), value))) {
+            SymbolValue value = vast_decl_builder();
+            if (failed(symbols.declare(kind, key, value))) {
                 error("error: multiple declarations with the same name: " + name);
             }
 
@@ -5,11 +5,13 @@
 #include "vast/Util/Warnings.hpp"
 
 VAST_RELAX_WARNINGS
-#include <llvm/ADT/ScopedHashTable.h>
+#include <clang/AST/APValue.h>
 #include <clang/AST/DeclVisitor.h>
 #include <clang/AST/Attr.h>
 #include <clang/Basic/Diagnostic.h>
 #include <clang/Frontend/FrontendDiagnostic.h>
+
+#include <mlir/IR/BuiltinAttributes.h>
 VAST_UNRELAX_WARNINGS
 
 #include "vast/CodeGen/CodeGenMeta.hpp"
@@ -387,7 +389,7 @@ namespace vast::cg {
                     declare_function_params(entry);
 
                     // emit label declarations
-                    llvm::ScopedHashTableScope labels_scope(context().labels);
+                    symbol_scope labels_scope(context().symbols);
 
                     for (const auto label : filter< clang::LabelDecl >(decl->decls()))
                         this->visit(label);
@@ -436,7 +438,7 @@ namespace vast::cg {
                 }
             };
 
-            llvm::ScopedHashTableScope scope(context().vars);
+            symbol_scope scope(context().symbols);
 
             auto linkage = core::get_function_linkage(gdecl);
 
@@ -501,6 +503,106 @@ namespace vast::cg {
             VAST_UNREACHABLE("unknown storage class");
         }
 
+        // Constant arrays with at least this many elements are initialized by
+        // a single dense constant instead of an initializer list.
+        static constexpr std::size_t dense_initializer_threshold = 16;
+
+        struct dense_elements {
+            llvm::SmallVector< std::int64_t > shape;
+            llvm::SmallVector< llvm::APInt > ints;
+            llvm::SmallVector< llvm::APFloat > floats;
+        };
+
+        bool collect_dense_elements(
+            const clang::APValue &value, clang::QualType type, dense_elements &dense, std::size_t depth
+        ) {
+            if (auto array = acontext().getAsConstantArrayType(type)) {
+                if (!value.isArray())
+                    return false;
+
+                auto size = array->getSize().getZExtValue();
+                if (depth == dense.shape.size())
+                    dense.shape.push_back(static_cast< std::int64_t >(size));
+
+                auto element_type = array->getElementType();
+                for (unsigned idx = 0; idx < size; ++idx) {
+                    const clang::APValue *element = nullptr;
+                    if (idx < value.getArrayInitializedElts())
+                        element = &value.getArrayInitializedElt(idx);
+                    else if (value.hasArrayFiller())
+                        element = &value.getArrayFiller();
+
+                    if (!element || !collect_dense_elements(*element, element_type, dense, depth + 1))
+                        return false;
+                }
+
+                return true;
+            }
+
+            if (value.isInt() && type->isIntegerType() && !type->isBooleanType() && dense.floats.empty()) {
+                dense.ints.push_back(value.getInt());
+                return true;
+            }
+
+            if (value.isFloat() && type->isRealFloatingType() && dense.ints.empty()) {
+                dense.floats.push_back(value.getFloat());
+                return true;
+            }
+
+            return false;
+        }
+
+        mlir_type dense_float_type(const llvm::fltSemantics &semantics) {
+            using fty = mlir::FloatType;
+            auto mctx = &mcontext();
+            if (&semantics == &llvm::APFloat::IEEEhalf())
+                return fty::getF16(mctx);
+            if (&semantics == &llvm::APFloat::BFloat())
+                return fty::getBF16(mctx);
+            if (&semantics == &llvm::APFloat::IEEEsingle())
+                return fty::getF32(mctx);
+            if (&semantics == &llvm::APFloat::IEEEdouble())
+                return fty::getF64(mctx);
+            if (&semantics == &llvm::APFloat::x87DoubleExtended())
+                return fty::getF80(mctx);
+            if (&semantics == &llvm::APFloat::IEEEquad())
+                return fty::getF128(mctx);
+            return {};
+        }
+
+        // Large tables of scalars (lookup tables, generated data) would
+        // otherwise produce a constant operation per element.
+        mlir::DenseElementsAttr make_dense_initializer(const clang::VarDecl *decl) {
+            if (!decl->hasGlobalStorage() || !acontext().getAsConstantArrayType(decl->getType()))
+                return {};
+
+            if (!clang::isa< clang::InitListExpr >(decl->getInit()->IgnoreImplicit()))
+                return {};
+
+            auto value = decl->evaluateValue();
+            if (!value)
+                return {};
+
+            dense_elements dense;
+            if (!collect_dense_elements(*value, decl->getType(), dense, 0))
+                return {};
+
+            if (dense.ints.size() + dense.floats.size() < dense_initializer_threshold)
+                return {};
+
+            if (!dense.ints.empty()) {
+                auto element_type = mlir::IntegerType::get(&mcontext(), dense.ints.front().getBitWidth());
+                auto type = mlir::RankedTensorType::get(dense.shape, element_type);
+                return mlir::DenseElementsAttr::get(type, dense.ints);
+            }
+
+            auto element_type = dense_float_type(dense.floats.front().getSemantics());
+            if (!element_type)
+                return {};
+            auto type = mlir::RankedTensorType::get(dense.shape, element_type);
+            return mlir::DenseElementsAttr::get(type, dense.floats);
+        }
+
         operation VisitVarDecl(const clang::VarDecl *decl) {
             auto var_decl = context().declare(decl, [&] {
                 auto type = decl->getType();
@@ -539,15 +641,21 @@ namespace vast::cg {
                 auto declared = mlir::dyn_cast< hl::VarDeclOp >(var_decl);
                 set_insertion_point_to_start(&declared.getInitializer());
 
-                auto value_builder = make_value_builder(decl->getInit());
-                value_builder(mlir_builder(), meta_location(decl));
+                if (auto dense = make_dense_initializer(decl)) {
+                    auto loc  = meta_location(decl);
+                    auto init = make< hl::DenseInitListExpr >(loc, visit(decl->getInit()->getType()), dense);
+                    make< hl::ValueYieldOp >(loc, init.getResult());
+                } else {
+                    auto value_builder = make_value_builder(decl->getInit());
+                    value_builder(mlir_builder(), meta_location(decl));
+                }
             }
 
             return var_decl;
         }
 
         operation VisitParmVarDecl(const clang::ParmVarDecl *decl) {
-            if (auto var = context().vars.lookup(decl))
+            if (auto var = context().lookup(decl))
                 return var.getDefiningOp();
             context().error("error: missing parameter declaration " + decl->getName());
             return nullptr;
@@ -639,11 +747,11 @@ namespace vast::cg {
                 auto prev = decl->getPreviousDecl();
 
                 if (!decl->isComplete()) {
-                    return context().enumdecls.lookup(prev);
+                    return context().lookup(prev);
                 }
 
                 while (prev) {
-                    if (auto prev_op = context().enumdecls.lookup(prev)) {
+                    if (auto prev_op = context().lookup(prev)) {
                         VAST_ASSERT(!prev->isComplete());
                         prev_op.setType(visit(decl->getIntegerType()));
                         auto guard = insertion_guard();
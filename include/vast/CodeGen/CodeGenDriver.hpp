@@ -7,6 +7,8 @@
 VAST_RELAX_WARNINGS
 #include <clang/AST/Decl.h>
 #include <clang/AST/GlobalDecl.h>
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/MapVector.h>
 VAST_UNRELAX_WARNINGS
 
 #include "vast/Dialect/HighLevel/HighLevelDialect.hpp"
@@ -50,17 +52,43 @@ namespace vast::cg
         );
     } // namespace detail
 
+    // Restricts the set of function definitions whose bodies are emitted,
+    // other definitions are emitted as declarations. Selection is made by
+    // mangled names and is empty if both lists are empty.
+    struct function_selection {
+        // Functions whose names fully match one of the regular expressions.
+        std::vector< std::string > patterns;
+        // Functions whose names are listed, together with everything they
+        // transitively call.
+        std::vector< std::string > roots;
+
+        bool empty() const { return patterns.empty() && roots.empty(); }
+    };
+
+    struct codegen_driver_options {
+        // Emit function bodies only after the whole translation unit is seen.
+        bool defer_function_bodies = false;
+
+        // Keep deferred bodies pending even after the translation unit is
+        // handled, bodies are then emitted on demand by `materialize`.
+        bool lazy_function_bodies = false;
+
+        function_selection selection = {};
+    };
+
     // This is a layer that provides interface between
     // clang codegen and vast codegen
 
     struct codegen_driver {
 
         explicit codegen_driver(
-            codegen_context &cgctx, cc::action_options &opts
+            codegen_context &cgctx, cc::action_options &opts,
+            codegen_driver_options driver_opts = {}
         )
             : actx(cgctx.actx)
             , mctx(cgctx.mctx)
             , opts(opts)
+            , driver_opts(std::move(driver_opts))
             , cxx_abi(create_cxx_abi(actx))
             , codegen(cgctx)
             , type_conv(*this)
@@ -89,6 +117,17 @@ namespace vast::cg
 
         void finalize();
 
+        // Until materialized, a deferred function definition is a private
+        // declaration in the module. The AST must outlive the driver.
+        bool is_materialized(hl::FuncOp fn) const;
+        hl::FuncOp materialize(hl::FuncOp fn);
+        // Returns null if there is no function of the given name.
+        hl::FuncOp materialize(string_ref symbol);
+        void materialize_all();
+        // Turns the definitions that were not materialized into declarations,
+        // e.g., before the module is lowered.
+        void drop_pending_function_bodies();
+
         const target_info_t &get_target_info() const { return *target_info; }
         target_info_t &get_target_info() { return *target_info; }
 
@@ -127,7 +166,7 @@ namespace vast::cg
             }
         }
 
-        codegen_context::var_table &variables_symbol_table();
+        symbol_table &symbols();
 
         bool has_this_return(clang::GlobalDecl decl) const;
         bool has_most_derived_return(clang::GlobalDecl decl) const;
@@ -136,6 +175,7 @@ namespace vast::cg
 
         operation build_global_definition(clang::GlobalDecl decl);
         operation build_global_function_definition(clang::GlobalDecl decl);
+        hl::FuncOp build_global_function_body(hl::FuncOp fn, clang::GlobalDecl decl);
         operation build_global_var_definition(const clang::VarDecl *decl, bool tentative = false);
 
         function_arg_list build_function_arg_list(clang::GlobalDecl decl);
@@ -148,6 +188,21 @@ namespace vast::cg
         // Emit any needed decls for which code generation was deferred.
         void build_deferred();
 
+        bool should_defer_function_bodies() const;
+
+        // Emits deferred decls and, unless they are lazy, deferred bodies
+        // until neither of them is pending.
+        void build_deferred_function_bodies();
+
+        using function_set = llvm::DenseSet< const clang::Decl * >;
+
+        // Turns deferred definitions outside of `driver_opts.selection` into
+        // declarations.
+        void drop_unselected_function_bodies(const function_set &selected);
+
+        // Canonical decls of the functions chosen by `driver_opts.selection`.
+        function_set selected_functions();
+
         // Helper for `build_deferred` to apply actual codegen.
         operation build_global_decl(const clang::GlobalDecl &decl);
         // Emit code for a single global function or var decl.
@@ -163,7 +218,7 @@ namespace vast::cg
         const std::vector< clang::GlobalDecl >& default_methods_to_emit() const;
         const std::vector< clang::GlobalDecl >& deferred_decls_to_emit() const;
         const std::vector< const clang::CXXRecordDecl * >& deferred_vtables() const;
-        const std::map< mangled_name_ref, clang::GlobalDecl >& deferred_decls() const;
+        const codegen_context::deferred_decls_map& deferred_decls() const;
 
         std::vector< clang::GlobalDecl > receive_deferred_decls_to_emit();
 
@@ -196,6 +251,13 @@ namespace vast::cg
 
         cc::action_options &opts;
 
+        // With deferred bodies, function definitions get only their
+        // prototypes while clang hands over top level decls. Bodies are
+        // emitted once the translation unit is complete, in the order of the
+        // prototypes.
+        codegen_driver_options driver_opts;
+        llvm::MapVector< operation, clang::GlobalDecl > deferred_function_bodies;
+
         unsigned deferred_top_level_decls = 0;
 
         friend struct defer_handle_of_top_level_decl;
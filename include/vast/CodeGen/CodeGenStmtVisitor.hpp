@@ -577,12 +577,12 @@ namespace vast::cg {
         }
 
         hl::VarDeclOp getDefiningOpOfGlobalVar(const clang::VarDecl *decl) {
-            return context().vars.lookup(decl).template getDefiningOp< hl::VarDeclOp >();
+            return context().lookup(decl).template getDefiningOp< hl::VarDeclOp >();
         }
 
         operation VisitEnumDeclRefExpr(const clang::DeclRefExpr *expr) {
             auto decl = clang::cast< clang::EnumConstantDecl >(expr->getDecl()->getUnderlyingDecl());
-            if (auto val = context().enumconsts.lookup(decl)) {
+            if (auto val = context().lookup(decl)) {
                 auto rty = visit(expr->getType());
                 return make< hl::EnumRefOp >(meta_location(expr), rty, val.getName());
             }
@@ -600,7 +600,7 @@ namespace vast::cg {
 
         operation VisitVarDeclRefExpr(const clang::DeclRefExpr *expr) {
             auto decl = getDeclForVarRef(expr);
-            if (auto var = context().vars.lookup(decl)) {
+            if (auto var = context().lookup(decl)) {
                 return VisitVarDeclRefExprImpl(expr, var);
             }
 
@@ -612,7 +612,7 @@ namespace vast::cg {
 
         operation VisitFileVarDeclRefExpr(const clang::DeclRefExpr *expr) {
             auto decl = getDeclForVarRef(expr);
-            if (!context().vars.lookup(decl)) {
+            if (!context().lookup(decl)) {
                 // Ref: https://github.com/trailofbits/vast/issues/384
                 // github issue to avoid emitting error if declaration is missing
                 context().error("error: missing global variable declaration " + decl->getName());
@@ -986,7 +986,9 @@ namespace vast::cg {
         }
 
         operation VisitIntegerLiteral(const clang::IntegerLiteral *lit) {
-            return VisitScalarLiteral(lit, llvm::APSInt(lit->getValue(), false));
+            return VisitScalarLiteral(lit, llvm::APSInt(
+                lit->getValue(), lit->getType()->isUnsignedIntegerOrEnumerationType()
+            ));
         }
 
         operation VisitFloatingLiteral(const clang::FloatingLiteral *lit) {
@@ -69,20 +69,21 @@ namespace vast::cg
         {}
 
         mangled_name_ref get_mangled_name(
-            clang::GlobalDecl decl, const clang::TargetInfo &target_info, const std::string &module_name_hash
+            clang::GlobalDecl decl, const clang::TargetInfo &target_info, string_ref module_name_hash
         );
 
         std::optional< clang::GlobalDecl >  lookup_representative_decl(mangled_name_ref name) const;
 
       private:
-        std::string mangle(
-            clang::GlobalDecl decl, const std::string &module_name_hash
+        void mangle(
+            clang::GlobalDecl decl, string_ref module_name_hash, llvm::raw_ostream &out
         ) const;
 
         std::unique_ptr< clang::MangleContext > mangle_context;
 
         // An ordered map of canonical GlobalDecls to their mangled names.
         llvm::MapVector< clang::GlobalDecl, mangled_name_ref > mangled_decl_names;
+        // Interns mangled names, mangled_name_refs point to its keys.
         llvm::StringMap< clang::GlobalDecl, llvm::BumpPtrAllocator > manglings;
     };
 
@@ -4,12 +4,22 @@
 
 #include "vast/Util/Warnings.hpp"
 
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/STLFunctionalExtras.h>
+VAST_UNRELAX_WARNINGS
+
 #include "vast/Util/Common.hpp"
 
+namespace mlir {
+    class PassManager;
+} // namespace mlir
+
 namespace vast::cg {
 
+    // The hook is called with the populated pass manager before it runs.
     logical_result emit_high_level_pass(
-        vast_module mod, mcontext_t *mctx, acontext_t *actx, bool enable_verifier
+        vast_module mod, mcontext_t *mctx, acontext_t *actx, bool enable_verifier,
+        llvm::function_ref< void(mlir::PassManager &) > hook = {}
     );
 
 } // namespace vast::cg
@@ -4,32 +4,123 @@
 
 #include "vast/Util/Warnings.hpp"
 
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Support/PointerLikeTypeTraits.h>
+#include <mlir/Support/LogicalResult.h>
+VAST_UNRELAX_WARNINGS
+
 #include <gap/core/generator.hpp>
 
+#include "vast/Util/Common.hpp"
+
+#include <cstdint>
 #include <functional>
 #include <queue>
+#include <vector>
 
 namespace vast::cg
 {
-    template< typename From, typename To >
-    struct scoped_table : llvm::ScopedHashTable< From, To >
-    {
-        using value_type = To;
-
-        using base = llvm::ScopedHashTable< From, To >;
-        using base::base;
+    // Kinds of symbols in the `symbol_table`. Variables and labels live in
+    // the innermost open scope, the other kinds are declared in the module
+    // scope and stay visible for the whole translation unit.
+    enum class symbol_kind : std::uint8_t {
+        var, label, type_def, type_decl, enum_decl, enum_constant, function
+    };
 
-        using base::count;
-        using base::insert;
+    constexpr bool is_module_level(symbol_kind kind) {
+        return kind != symbol_kind::var && kind != symbol_kind::label;
+    }
+
+    // Symbols of all kinds kept in a single hash keyed by the kind and the
+    // declaration. Entries are stored inline in the hash and remember the
+    // scope they were declared in, an entry is visible only while its scope
+    // is open. Hence closing a scope does not touch the hash, entries of
+    // closed scopes are dropped at once when codegen returns to the module
+    // scope, i.e., at the end of each function.
+    struct symbol_table {
+        using key_t = std::pair< symbol_kind, const void * >;
+
+        template< typename value_t >
+        value_t lookup(symbol_kind kind, const void *key) const {
+            if (auto entry = find(kind, key)) {
+                return llvm::PointerLikeTypeTraits< value_t >::getFromVoidPointer(entry->value);
+            }
+            return {};
+        }
 
-        logical_result declare(const From &from, const To &to) {
-            if (count(from)) {
+        template< typename value_t >
+        logical_result declare(symbol_kind kind, const void *key, value_t value) {
+            if (find(kind, key)) {
                 return mlir::failure();
             }
 
-            insert(from, to);
+            VAST_ASSERT(!scopes.empty() && "no scope is open");
+            auto depth = is_module_level(kind) ? 0u : static_cast< unsigned >(scopes.size() - 1);
+            auto ptr   = llvm::PointerLikeTypeTraits< value_t >::getAsVoidPointer(value);
+
+            entries[{ kind, key }] = { ptr, depth, scopes[depth] };
+            if (depth > 0) {
+                local_keys.emplace_back(kind, key);
+            }
+
             return mlir::success();
         }
+
+        void push_scope() { scopes.push_back(next_scope++); }
+
+        void pop_scope() {
+            VAST_ASSERT(!scopes.empty() && "no scope is open");
+            scopes.pop_back();
+
+            if (scopes.size() == 1) {
+                for (const auto &key : local_keys) {
+                    if (auto it = entries.find(key); it != entries.end() && it->second.depth > 0) {
+                        entries.erase(it);
+                    }
+                }
+                // Keeps the capacity for the next function.
+                local_keys.clear();
+            } else if (scopes.empty()) {
+                entries.clear();
+                local_keys.clear();
+            }
+        }
+
+      private:
+        struct entry {
+            void *value;
+            unsigned depth;
+            unsigned scope;
+        };
+
+        const entry *find(symbol_kind kind, const void *key) const {
+            auto it = entries.find({ kind, key });
+            if (it == entries.end()) {
+                return nullptr;
+            }
+
+            const auto &e = it->second;
+            return e.depth < scopes.size() && scopes[e.depth] == e.scope ? &e : nullptr;
+        }
+
+        llvm::DenseMap< key_t, entry > entries;
+        // Identifiers of open scopes, indexed by depth.
+        llvm::SmallVector< unsigned, 8 > scopes;
+        // Keys declared in scopes nested in the module scope.
+        std::vector< key_t > local_keys;
+        unsigned next_scope = 0;
+    };
+
+    struct symbol_scope {
+        explicit symbol_scope(symbol_table &table) : table(table) { table.push_scope(); }
+        ~symbol_scope() { table.pop_scope(); }
+
+        symbol_scope(const symbol_scope &) = delete;
+        symbol_scope &operator=(const symbol_scope &) = delete;
+
+        symbol_table &table;
     };
 
     struct scope_context {
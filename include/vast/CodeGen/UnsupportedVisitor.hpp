@@ -31,16 +31,24 @@ namespace vast::cg {
 
         using lens::meta_location;
 
+        struct child_builder
+        {
+            unsup_stmt_visitor *self;
+            const clang::Stmt *child;
+
+            void operator()(Builder &, Location) const { self->visit(child); }
+        };
+
         operation make_unsupported_stmt(auto stmt, mlir_type type = {}) {
-            std::vector< BuilderCallBackFn > children;
+            // For each subexpression, the unsupported operation holds a region.
+            // Last value of the region is an operand of the expression.
+            llvm::SmallVector< child_builder, 4 > builders;
             for (auto ch : stmt->children()) {
-                // For each subexpression, the unsupported operation holds a region.
-                // Last value of the region is an operand of the expression.
-                children.push_back([this, ch](auto &bld, auto loc) {
-                    this->visit(ch);
-                });
+                builders.push_back({ this, ch });
             }
 
+            llvm::SmallVector< BuilderCallBackFn, 4 > children(builders.begin(), builders.end());
+
             return this->template make_operation< unsup::UnsupportedStmt >()
                 .bind(meta_location(stmt))
                 .bind(stmt->getStmtClassName())
@@ -72,9 +80,12 @@ namespace vast::cg {
         using lens::make_operation;
         using lens::meta_location;
 
-        auto make_body_callback(auto decl) -> std::optional< BuilderCallBackFn > {
+        // Builds the operation by `make` with a callback that visits the body
+        // of `decl`, if it has any. The callback lives only during `make`.
+        operation with_body_callback(auto decl, auto &&make) {
             auto callback = [&] (auto body) {
-                return [&, body] (auto &bld, auto loc) { visit(body); };
+                auto builder = [&, body] (auto &bld, auto loc) { visit(body); };
+                return make(BuilderCallback(builder));
             };
 
             #define VAST_UNSUPPORTED_DECL_BODY_CALLBACK(type, body) \
@@ -93,14 +104,15 @@ namespace vast::cg {
             #undef VAST_UNSUPPORTED_DECL_BODY_CALLBACK
 
             if (auto d = mlir::dyn_cast< clang::DeclContext >(decl)) {
-                return [this, d] (auto &bld, auto loc) {
+                auto builder = [this, d] (auto &bld, auto loc) {
                     for (auto child : d->decls()) {
                         this->visit(child);
                     }
                 };
+                return make(BuilderCallback(builder));
             }
 
-            return std::nullopt;
+            return make(BuilderCallback(std::nullopt));
         };
 
         std::string decl_name(auto decl) {
@@ -113,15 +125,13 @@ namespace vast::cg {
         }
 
         operation make_unsupported_decl(auto decl) {
-            auto op = this->template make_operation< unsup::UnsupportedDecl >()
-                .bind(meta_location(decl)) // location
-                .bind(decl_name(decl));    // name
-
-            if (auto callback = make_body_callback(decl)) {
-                return std::move(op).bind(callback.value()).freeze(); // body
-            }
-
-            return op.freeze();
+            return with_body_callback(decl, [&] (BuilderCallback body) -> operation {
+                return this->template make_operation< unsup::UnsupportedDecl >()
+                    .bind(meta_location(decl))               // location
+                    .bind(decl_name(decl))                   // name
+                    .bind_region_if(body.has_value(), body)  // body
+                    .freeze();
+            });
         }
 
         operation Visit(const clang::Decl *decl) {
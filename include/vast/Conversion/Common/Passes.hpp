@@ -233,8 +233,14 @@ namespace vast {
 
             if (failed(populate::apply_conversions(std::move(cfg))))
                 return signalPassFailure();
+
+            this->after_operation();
         }
 
         void runOnOperation() override { run_on_operation(); }
+
+        // Override to specify what is supposed to run after `run_on_operation` is finished.
+        // This will run *only if the `run_on_operation* was successful.
+        virtual void after_operation() {};
     };
 }
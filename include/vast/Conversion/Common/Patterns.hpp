@@ -6,6 +6,7 @@
 #include "vast/Util/Common.hpp"
 
 #include "vast/Conversion/Common/Types.hpp"
+#include "vast/Dialect/Core/CoreDialect.hpp"
 
 VAST_RELAX_WARNINGS
 #include "mlir/Transforms/DialectConversion.h"
@@ -139,6 +140,26 @@ namespace vast {
         }
 
 
+        // Branch weights attached by `vast-hl-profile-use`, ordered as the
+        // successors of the branch.
+        static llvm::ArrayRef< std::int32_t > branch_weights(operation op) {
+            auto weights = op->getAttrOfType< mlir::DenseI32ArrayAttr >(
+                core::CoreDialect::getBranchWeightsAttrName()
+            );
+            return weights ? weights.asArrayRef() : llvm::ArrayRef< std::int32_t >();
+        }
+
+        static auto cond_branch_weights(operation op)
+            -> std::optional< std::pair< std::uint32_t, std::uint32_t > >
+        {
+            auto weights = branch_weights(op);
+            if (weights.size() != 2)
+                return std::nullopt;
+            return std::make_pair(
+                static_cast< std::uint32_t >(weights[0]), static_cast< std::uint32_t >(weights[1])
+            );
+        }
+
         static auto replace_with_trunc_or_ext(
             auto op, auto src, auto orig_src_type, mlir_type dst_type, auto &rewriter
         ) -> mlir_value {
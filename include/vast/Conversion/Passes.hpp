@@ -12,6 +12,10 @@ VAST_RELAX_WARNINGS
 
 #include <mlir/Pass/Pass.h>
 #include <mlir/Pass/PassManager.h>
+
+#include <mlir/Conversion/Passes.h>
+#include <mlir/Transforms/GreedyPatternRewriteDriver.h>
+#include <mlir/Transforms/Passes.h>
 VAST_UNRELAX_WARNINGS
 
 #include <vast/Dialect/HighLevel/HighLevelDialect.hpp>
@@ -57,6 +61,12 @@ namespace vast
 
     std::unique_ptr< mlir::Pass > createHLToLLFuncPass();
 
+    std::unique_ptr< mlir::Pass > createHLToSCFPass();
+
+    std::unique_ptr< mlir::Pass > createSCFUnrollPass();
+
+    std::unique_ptr< mlir::Pass > createEmitLifetimeMarkersPass();
+
     // Generate the code for registering passes.
     #define GEN_PASS_REGISTRATION
     #include "vast/Conversion/Passes.h.inc"
@@ -68,11 +78,13 @@ namespace vast
         pm.addPass(createLowerABIPass());
     }
 
-    static inline void build_to_ll_pipeline(mlir::PassManager &pm)
+    static inline void build_to_ll_pipeline(mlir::PassManager &pm, bool lifetime_markers = false)
     {
         pm.addPass(createHLToLLFuncPass());
         pm.addPass(createHLToLLVarsPass());
         pm.addPass(createHLToLLCFPass());
+        if (lifetime_markers)
+            pm.addPass(createEmitLifetimeMarkersPass());
         pm.addPass(createHLEmitLazyRegionsPass());
         pm.addPass(createHLToLLGEPsPass());
     }
@@ -84,4 +96,69 @@ namespace vast
         pm.addPass(createCoreToLLVMPass());
     }
 
+    // Optimizations of the low-level form, runs after `build_to_ll_pipeline`.
+    // Regions are kept intact, as lazy operations still rely on them.
+    static inline void build_optimize_ll_pipeline(mlir::PassManager &pm, unsigned opt_level)
+    {
+        if (opt_level == 0)
+            return;
+
+        mlir::GreedyRewriteConfig config;
+        config.enableRegionSimplification = false;
+        pm.addPass(mlir::createCanonicalizerPass(config));
+        pm.addPass(mlir::createCSEPass());
+    }
+
+    // Optimizations of the LLVM dialect before translation, so that the LLVM
+    // backend gets a smaller module.
+    static inline void build_optimize_llvm_pipeline(mlir::PassManager &pm, unsigned opt_level)
+    {
+        if (opt_level == 0)
+            return;
+
+        pm.addPass(mlir::createCanonicalizerPass());
+        pm.addPass(mlir::createCSEPass());
+
+        if (opt_level < 2)
+            return;
+
+        pm.addPass(mlir::createInlinerPass());
+        pm.addPass(mlir::createSymbolDCEPass());
+        pm.addPass(mlir::createCanonicalizerPass());
+        pm.addPass(mlir::createCSEPass());
+    }
+
+    // Loop transformations of loops raised to `scf`.
+    static inline void build_optimize_scf_pipeline(mlir::PassManager &pm, unsigned opt_level)
+    {
+        if (opt_level == 0)
+            return;
+
+        pm.addPass(mlir::createLoopInvariantCodeMotionPass());
+
+        if (opt_level < 2)
+            return;
+
+        pm.addPass(createSCFUnrollPass());
+        pm.addPass(mlir::createCSEPass());
+    }
+
+    // Raises loops to `scf` so that upstream loop transformations can run on
+    // them and lowers them back to unstructured control flow. `hl` statements
+    // of loop bodies end up in multi-block function bodies, which
+    // `build_to_ll_pipeline` lowers like any other blocks. Needs to run before
+    // `build_to_ll_pipeline` and be followed by `build_scf_to_llvm_pipeline`.
+    static inline void build_scf_pipeline(mlir::PassManager &pm, unsigned opt_level)
+    {
+        pm.addPass(createHLToSCFPass());
+        build_optimize_scf_pipeline(pm, opt_level);
+        pm.addPass(mlir::createConvertSCFToCFPass());
+    }
+
+    static inline void build_scf_to_llvm_pipeline(mlir::PassManager &pm)
+    {
+        pm.addPass(mlir::createArithToLLVMConversionPass());
+        pm.addPass(mlir::createConvertControlFlowToLLVMPass());
+    }
+
 } // namespace vast
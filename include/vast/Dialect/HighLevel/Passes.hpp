@@ -8,6 +8,8 @@ VAST_RELAX_WARNINGS
 #include <mlir/IR/Operation.h>
 #include <mlir/Pass/Pass.h>
 #include <mlir/Pass/PassManager.h>
+
+#include <llvm/ADT/StringRef.h>
 VAST_UNRELAX_WARNINGS
 
 #include <vast/Dialect/HighLevel/HighLevelDialect.hpp>
@@ -17,16 +19,40 @@ namespace vast::hl
 {
     std::unique_ptr< mlir::Pass > createHLLowerTypesPass();
 
+    std::unique_ptr< mlir::Pass > createHLFoldPass();
+
     std::unique_ptr< mlir::Pass > createExportFnInfoPass();
 
     std::unique_ptr< mlir::Pass > createDCEPass();
 
     std::unique_ptr< mlir::Pass > createLowerTypeDefsPass();
 
+    std::unique_ptr< mlir::Pass > createPromoteVarsPass();
+
+    std::unique_ptr< mlir::Pass > createSymbolDCEPass();
+
+    std::unique_ptr< mlir::Pass > createInstrumentProfilePass();
+
+    std::unique_ptr< mlir::Pass > createProfileUsePass();
+
+    std::unique_ptr< mlir::Pass > createProfileUsePass(std::string path);
+
     std::unique_ptr< mlir::Pass > createSpliceTrailingScopes();
 
     std::unique_ptr< mlir::Pass > createHLCanonicalizePass();
 
+    namespace profile::runtime
+    {
+        // Symbols emitted by `InstrumentProfile`. Calls of the increment marker
+        // are lowered to inline atomic adds and the init function is run as a
+        // module constructor when lowering to LLVM.
+        inline constexpr llvm::StringLiteral counters_name  = "__vast_prof_counters";
+        inline constexpr llvm::StringLiteral keys_name      = "__vast_prof_keys";
+        inline constexpr llvm::StringLiteral increment_name = "__vast_prof_inc";
+        inline constexpr llvm::StringLiteral register_name  = "__vast_prof_register";
+        inline constexpr llvm::StringLiteral init_name      = "__vast_prof_init";
+    } // namespace profile::runtime
+
     void registerHLToLLVMIR(mlir::DialectRegistry &);
     void registerHLToLLVMIR(mlir::MLIRContext &);
 
@@ -34,8 +60,20 @@ namespace vast::hl
     #define GEN_PASS_REGISTRATION
     #include "vast/Dialect/HighLevel/Passes.h.inc"
 
+    // Runs on types with qualifiers, therefore before `HLLowerTypes`.
+    static inline void build_optimize_hl_pipeline(mlir::PassManager &pm, unsigned opt_level)
+    {
+        if (opt_level == 0)
+            return;
+
+        pm.addPass(createSymbolDCEPass());
+        pm.addPass(createPromoteVarsPass());
+    }
+
+    // Folding needs high-level types to respect C semantics.
     static inline void build_simplify_hl_pipeline(mlir::PassManager &pm)
     {
+        pm.addPass(createHLFoldPass());
         pm.addPass(createHLLowerTypesPass());
         pm.addPass(createDCEPass());
         pm.addPass(createLowerTypeDefsPass());
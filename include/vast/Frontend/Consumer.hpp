@@ -16,6 +16,8 @@ VAST_UNRELAX_WARNINGS
 #include "vast/CodeGen/CodeGenContext.hpp"
 #include "vast/CodeGen/CodeGenDriver.hpp"
 
+#include "vast/Util/IRProfile.hpp"
+
 namespace vast::cc {
 
     using output_stream_ptr = std::unique_ptr< llvm::raw_pwrite_stream >;
@@ -71,10 +73,17 @@ namespace vast::cc {
             backend backend_action, owning_module_ref mlir_module, mcontext_t *mctx
         );
 
+        void emit_split_object(
+            std::unique_ptr< llvm::Module > mod, string_ref data_layout,
+            unsigned partitions, string_ref linker
+        );
+
         void emit_mlir_output(target_dialect target, owning_module_ref mod, mcontext_t *mctx);
 
         void compile_via_vast(vast_module mod, mcontext_t *mctx);
 
+        void profile_passes(mlir::PassManager &pm);
+
         virtual void anchor() {}
 
         output_type action;
@@ -93,5 +102,11 @@ namespace vast::cc {
         std::unique_ptr< mcontext_t > mctx = nullptr;
         std::unique_ptr< cg::codegen_context > cgctx = nullptr;
         std::unique_ptr< cg::codegen_driver > codegen = nullptr;
+
+        //
+        // profiling of vast pipelines, enabled by `-vast-profile-ir`
+        //
+        std::unique_ptr< ir_profile > pass_profile = nullptr;
+        ir_profile_format pass_profile_format = ir_profile_format::table;
     };
 } // namespace vast::cc
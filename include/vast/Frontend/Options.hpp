@@ -77,6 +77,21 @@ namespace vast::cc
         constexpr string_ref emit_locs = "emit-locs";
 
         constexpr string_ref opt_pipeline  = "pipeline";
+        constexpr string_ref opt_level     = "opt-level";
+
+        constexpr string_ref codegen_partitions = "codegen-partitions";
+
+        constexpr string_ref defer_function_bodies = "defer-function-bodies";
+        constexpr string_ref emit_only             = "emit-only";
+        constexpr string_ref reachable_from        = "reachable-from";
+        constexpr string_ref materialize           = "materialize";
+
+        constexpr string_ref emit_lifetime_markers = "emit-lifetime-markers";
+
+        constexpr string_ref instrument_profile = "instrument-profile";
+        constexpr string_ref profile_use        = "profile-use";
+
+        constexpr string_ref profile_ir = "profile-ir";
 
         constexpr string_ref disable_vast_verifier = "disable-vast-verifier";
         constexpr string_ref vast_verify_diags = "verify-diags";
@@ -6,6 +6,7 @@
 #include "vast/Util/Common.hpp"
 
 VAST_RELAX_WARNINGS
+#include <llvm/ADT/STLFunctionalExtras.h>
 #include <mlir/IR/DialectRegistry.h>
 VAST_UNRELAX_WARNINGS
 
@@ -21,6 +22,7 @@ namespace llvm
 namespace mlir
 {
     class Operation;
+    class PassManager;
 }
 
 namespace vast::target::llvmir
@@ -30,7 +32,8 @@ namespace vast::target::llvmir
     enum class pipeline : uint32_t
     {
         baseline = 0,
-        with_abi = 1
+        with_abi = 1,
+        with_scf = 2
     };
 
     static inline pipeline default_pipeline()
@@ -49,6 +52,12 @@ namespace vast::target::llvmir
     // to a module in lowest representation (mostly LLVM dialect right now).
     void lower_hl_module(mlir::Operation *op, pipeline p);
 
+    // Called with the populated pass manager right before it runs, e.g. to
+    // attach instrumentations.
+    using pass_manager_hook = llvm::function_ref< void(mlir::PassManager &) >;
+
+    void lower_hl_module(mlir::Operation *op, pipeline p, pass_manager_hook hook);
+
     static inline void lower_hl_module(mlir::Operation *op)
     {
         return lower_hl_module(op, default_pipeline());
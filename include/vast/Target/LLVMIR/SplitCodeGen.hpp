@@ -0,0 +1,54 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/TargetParser/Triple.h>
+VAST_UNRELAX_WARNINGS
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace llvm
+{
+    class Module;
+    class TargetMachine;
+} // namespace llvm
+
+namespace vast::target::llvmir
+{
+    using object_buffer = std::unique_ptr< llvm::MemoryBuffer >;
+
+    // Every worker thread needs its own target machine.
+    using target_machine_factory = std::function< std::unique_ptr< llvm::TargetMachine >() >;
+
+    // Splits already optimized `mod` into `partitions` symbol-closed modules,
+    // local symbols stay local and are kept in one partition with all their
+    // users. Partitions are compiled to object files in parallel, each in its
+    // own context.
+    //
+    // Objects are returned in the partition order. The partitioning depends
+    // only on the module and the number of partitions, never on the number of
+    // threads, so the output is deterministic.
+    llvm::Expected< std::vector< object_buffer > > split_codegen(
+        llvm::Module &mod, unsigned partitions, const target_machine_factory &make_target_machine
+    );
+
+    // Looks up a linker able to merge objects for `target` into a relocatable
+    // one: `ld.lld` for ELF targets, the system `ld` only for the host target.
+    std::optional< std::string > find_relocatable_linker(const llvm::Triple &target);
+
+    // Merges objects into a single relocatable object using `linker -r`.
+    llvm::Expected< object_buffer > link_relocatable(
+        llvm::StringRef linker, llvm::ArrayRef< object_buffer > objects
+    );
+
+} // namespace vast::target::llvmir
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "vast/Util/Common.hpp"
+#include "vast/Util/IRProfile.hpp"
 
 VAST_RELAX_WARNINGS
 #include <mlir/Pass/PassManager.h>
@@ -57,16 +58,24 @@ namespace vast::tw {
         auto apply(handle_t handle, pass_ptr_t pass) -> handle_t {
             mlir::PassManager pm(_ctx);
             pm.addPass(std::move(pass));
+            if (_profile) {
+                _profile->attach(pm);
+            }
             return apply(handle, pm);
         }
 
         auto top() -> handle_t { return { _modules.size(), _modules.back().get() }; }
 
+        // Passes applied by the tower are recorded in the profile, pass
+        // managers given to `apply` have to be profiled by the caller.
+        auto set_profile(ir_profile *profile) -> void { _profile = profile; }
+
       private:
         using module_storage_t = llvm::SmallVector< owning_module_ref, 2 >;
 
         mcontext_t *_ctx;
         module_storage_t _modules;
+        ir_profile *_profile = nullptr;
 
         tower(mcontext_t &ctx, owning_module_ref mod) : _ctx(&ctx) {
             _modules.emplace_back(std::move(mod));
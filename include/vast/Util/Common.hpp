@@ -38,7 +38,8 @@ namespace vast {
 
     using BuilderCallback = std::optional< llvm::function_ref< void(Builder &, Location) > >;
 
-    using BuilderCallBackFn = std::function< void(Builder &, Location) >;
+    // Non-owning, the callable has to outlive the build of the operation.
+    using BuilderCallBackFn = llvm::function_ref< void(Builder &, Location) >;
 
     using acontext_t = clang::ASTContext;
     using mcontext_t = mlir::MLIRContext;
@@ -0,0 +1,76 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/MapVector.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Support/raw_ostream.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Util/Common.hpp"
+
+#include <mutex>
+
+namespace mlir {
+    class PassManager;
+} // namespace mlir
+
+namespace vast {
+
+    // Size of the IR nested in an operation, the operation itself included.
+    struct ir_stats {
+        llvm::StringMap< std::size_t > ops;
+        llvm::StringMap< std::size_t > dialects;
+        std::size_t blocks  = 0;
+        std::size_t regions = 0;
+        // Distinct attributes and types referenced from the IR, including
+        // locations and nested parameters. The uniquer of the context is not
+        // observable, these are the part of it kept alive by the IR.
+        std::size_t attributes = 0;
+        std::size_t types      = 0;
+
+        static ir_stats collect(operation op);
+
+        std::size_t total_ops() const;
+
+        ir_stats &operator+=(const ir_stats &other);
+    };
+
+    struct ir_pass_profile {
+        std::size_t runs = 0;
+        double seconds   = 0;
+        ir_stats before;
+        ir_stats after;
+    };
+
+    enum class ir_profile_format { table, json };
+
+    std::optional< ir_profile_format > parse_ir_profile_format(string_ref format);
+
+    // Records the size of the IR before and after each pass and the time
+    // spent in it. Statistics of passes run on nested operations, e.g. per
+    // function, are summed over all runs, so the difference of `after` and
+    // `before` is the growth caused by the pass. Passes are kept in order of
+    // their first run. Profiling does not own the pass manager and can
+    // outlive it, which allows to accumulate results of several pipelines.
+    struct ir_profile {
+        // Adds an instrumentation feeding this profile to the pass manager.
+        void attach(mlir::PassManager &pm);
+
+        void record(string_ref pass, const ir_stats &before, const ir_stats &after, double seconds);
+
+        void print(llvm::raw_ostream &os, ir_profile_format format) const;
+        void print_table(llvm::raw_ostream &os) const;
+        void print_json(llvm::raw_ostream &os) const;
+
+        const llvm::MapVector< std::string, ir_pass_profile > &passes() const { return profiles; }
+
+      private:
+        mutable std::mutex mutex;
+        llvm::MapVector< std::string, ir_pass_profile > profiles;
+    };
+
+} // namespace vast
@@ -61,6 +61,17 @@ namespace vast::repl
             VAST_UNREACHABLE("uknnown show kind: {0}", token.str());
         }
 
+        enum class profile_action { start, stop, table, json };
+
+        template< typename enum_type >
+        enum_type from_string(string_ref token) requires(std::is_same_v< enum_type, profile_action >) {
+            if (token == "start") return enum_type::start;
+            if (token == "stop")  return enum_type::stop;
+            if (token == "table") return enum_type::table;
+            if (token == "json")  return enum_type::json;
+            VAST_UNREACHABLE("unknown profile action: {0}", token.str());
+        }
+
         enum class meta_action { add, get };
 
         template< typename enum_type >
@@ -238,7 +249,29 @@ namespace vast::repl
             params_storage params;
         };
 
-        using command_list = util::type_list< exit, help, load, show, meta, raise >;
+        //
+        // profile command
+        //
+        struct profile : base {
+            static constexpr string_ref name() { return "profile"; }
+
+            static constexpr inline char action_param[] = "profile_action";
+
+            using command_params = util::type_list<
+                named_param< action_param, profile_action >
+            >;
+
+            using params_storage = command_params::as_tuple;
+
+            profile(const params_storage &params) : params(params) {}
+            profile(params_storage &&params) : params(std::move(params)) {}
+
+            void run(state_t &state) const override;
+
+            params_storage params;
+        };
+
+        using command_list = util::type_list< exit, help, load, show, meta, raise, profile >;
 
     } // namespace command
 
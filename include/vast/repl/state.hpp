@@ -3,6 +3,7 @@
 #pragma once
 
 #include "vast/Tower/Tower.hpp"
+#include "vast/Util/IRProfile.hpp"
 #include "vast/repl/common.hpp"
 
 namespace vast::repl {
@@ -16,6 +17,9 @@ namespace vast::repl {
 
         mcontext_t &ctx;
         std::optional< tw::default_tower > tower;
+
+        // Profile of raised pipelines, enabled by `profile start`.
+        std::optional< ir_profile > profile;
     };
 
 } // namespace vast::repl
@@ -1,7 +1,17 @@
 // Copyright (c) 2022-present, Trail of Bits, Inc.
 
 #include "vast/CodeGen/CodeGen.hpp"
+#include "vast/CodeGen/CodeGen.inl"
 
 namespace vast::cg
 {
+    template struct codegen_base<
+        visitor_instance< codegen_context, default_visitor_stack, default_meta_gen >, codegen_context
+    >;
+    template struct codegen_base<
+        visitor_instance< codegen_context, default_visitor_stack, id_meta_gen >, codegen_context
+    >;
+
+    template struct codegen_instance< codegen_context, default_visitor_stack, default_meta_gen >;
+    template struct codegen_instance< codegen_context, default_visitor_stack, id_meta_gen >;
 } // namespace vast::cg
@@ -4,9 +4,14 @@
 
 VAST_RELAX_WARNINGS
 #include <clang/AST/GlobalDecl.h>
+#include <clang/Analysis/CallGraph.h>
+#include <clang/Basic/Diagnostic.h>
 #include <clang/Basic/TargetInfo.h>
+#include <llvm/Support/Regex.h>
 VAST_UNRELAX_WARNINGS
 
+#include "vast/Dialect/Core/Linkage.hpp"
+
 // FIXME: get rid of dependency from upper layer
 #include "vast/CodeGen/TypeInfo.hpp"
 
@@ -146,9 +151,163 @@ namespace vast::cg
     }
 
     void codegen_driver::handle_translation_unit(acontext_t &/* acontext */) {
+        if (should_defer_function_bodies()) {
+            build_deferred_function_bodies();
+        }
         finalize();
     }
 
+    void codegen_driver::build_deferred_function_bodies() {
+        auto selected = selected_functions();
+
+        // Deferred decls, e.g., static functions used before their definition,
+        // queue their bodies, and bodies queue further deferred decls. Both
+        // are drained until neither of them grows.
+        do {
+            build_deferred();
+            drop_unselected_function_bodies(selected);
+            if (!driver_opts.lazy_function_bodies) {
+                materialize_all();
+            }
+        } while (!deferred_decls_to_emit().empty());
+    }
+
+    bool codegen_driver::is_materialized(hl::FuncOp fn) const {
+        return !deferred_function_bodies.count(fn.getOperation());
+    }
+
+    hl::FuncOp codegen_driver::materialize(hl::FuncOp fn) {
+        auto it = deferred_function_bodies.find(fn.getOperation());
+        if (it == deferred_function_bodies.end()) {
+            return fn;
+        }
+
+        auto decl = it->second;
+        deferred_function_bodies.erase(it);
+
+        fn.setVisibility(core::get_visibility_from_linkage(fn.getLinkage()));
+        fn = build_global_function_body(fn, decl);
+
+        // Deferred decls first used by the body, e.g., inline methods, are
+        // queued as pending bodies too, and the types of the body extend the
+        // data layout.
+        build_deferred();
+        codegen.emit_data_layout();
+        return fn;
+    }
+
+    hl::FuncOp codegen_driver::materialize(string_ref symbol) {
+        if (auto fn = mlir::dyn_cast_or_null< hl::FuncOp >(get_global_value(mangled_name_ref{ symbol }))) {
+            return materialize(fn);
+        }
+
+        return {};
+    }
+
+    void codegen_driver::materialize_all() {
+        for (auto &[op, decl] : deferred_function_bodies.takeVector()) {
+            auto fn = mlir::cast< hl::FuncOp >(op);
+            fn.setVisibility(core::get_visibility_from_linkage(fn.getLinkage()));
+            build_global_function_body(fn, decl);
+        }
+    }
+
+    void codegen_driver::drop_pending_function_bodies() {
+        for (auto &entry : deferred_function_bodies.takeVector()) {
+            // A function without body cannot have internal linkage.
+            mlir::cast< hl::FuncOp >(entry.first).setLinkage(core::GlobalLinkageKind::ExternalLinkage);
+        }
+    }
+
+    void codegen_driver::drop_unselected_function_bodies(const function_set &selected) {
+        if (driver_opts.selection.empty()) {
+            return;
+        }
+
+        deferred_function_bodies.remove_if([&] (const auto &entry) {
+            const auto &[op, decl] = entry;
+            if (selected.contains(decl.getDecl()->getCanonicalDecl())) {
+                return false;
+            }
+
+            // A function without body cannot have internal linkage.
+            mlir::cast< hl::FuncOp >(op).setLinkage(core::GlobalLinkageKind::ExternalLinkage);
+            return true;
+        });
+    }
+
+    bool codegen_driver::should_defer_function_bodies() const {
+        // Callers of a function may follow its definition, so the selection
+        // is known only at the end of the translation unit.
+        return driver_opts.defer_function_bodies
+            || driver_opts.lazy_function_bodies
+            || !driver_opts.selection.empty();
+    }
+
+    codegen_driver::function_set codegen_driver::selected_functions() {
+        const auto &selection = driver_opts.selection;
+        if (selection.empty()) {
+            return {};
+        }
+
+        // An invalid pattern would silently match nothing.
+        auto &diags = actx.getDiagnostics();
+        std::vector< llvm::Regex > patterns;
+        for (const auto &pattern : selection.patterns) {
+            llvm::Regex regex("^(" + pattern + ")$");
+            if (std::string error; !regex.isValid(error)) {
+                diags.Report(diags.getCustomDiagID(
+                    clang::DiagnosticsEngine::Error, "invalid -vast-emit-only pattern '%0': %1"
+                )) << pattern << error;
+                continue;
+            }
+            patterns.push_back(std::move(regex));
+        }
+
+        auto matches = [&] (string_ref name) {
+            return llvm::any_of(patterns, [&] (const auto &regex) { return regex.match(name); });
+        };
+
+        auto is_root = [&] (string_ref name) {
+            return llvm::is_contained(selection.roots, name);
+        };
+
+        clang::CallGraph graph;
+        graph.addToCallGraph(actx.getTranslationUnitDecl());
+
+        function_set selected;
+        llvm::SmallVector< const clang::CallGraphNode * > worklist;
+
+        for (const auto &[decl, node] : graph) {
+            const auto *fn = llvm::dyn_cast_or_null< clang::FunctionDecl >(decl);
+            if (!fn) {
+                continue;
+            }
+
+            auto name = get_mangled_name(fn).name;
+            if (is_root(name)) {
+                selected.insert(fn->getCanonicalDecl());
+                worklist.push_back(node.get());
+            } else if (matches(name)) {
+                selected.insert(fn->getCanonicalDecl());
+            }
+        }
+
+        // The call graph records direct calls only, functions whose address
+        // is taken are not followed.
+        while (!worklist.empty()) {
+            const auto *node = worklist.pop_back_val();
+            for (const auto &record : *node) {
+                const auto *callee = record.Callee->getDecl();
+                if (callee && selected.insert(callee->getCanonicalDecl()).second) {
+                    worklist.push_back(record.Callee);
+                }
+            }
+        }
+
+        return selected;
+    }
+
     void codegen_driver::handle_top_level_decl(clang::DeclGroupRef decls) {
         defer_handle_of_top_level_decl defer(*this);
 
@@ -237,14 +396,25 @@ namespace vast::cg
     operation codegen_driver::build_global_function_definition(clang::GlobalDecl decl) {
         auto fn = mlir::cast< hl::FuncOp >(build_global_function_declaration(decl));
 
-        const auto *function_decl = llvm::cast< clang::FunctionDecl >(decl.getDecl());
-        const auto &fty_info = type_info->arrange_global_decl(decl, get_target_info());
-
         // Already emitted.
         if (!fn.isDeclaration()) {
             return fn;
         }
 
+        if (should_defer_function_bodies()) {
+            // MLIR requires declarations to have private visibility.
+            fn.setVisibility(mlir::SymbolTable::Visibility::Private);
+            deferred_function_bodies.insert({ fn.getOperation(), decl });
+            return fn;
+        }
+
+        return build_global_function_body(fn, decl);
+    }
+
+    hl::FuncOp codegen_driver::build_global_function_body(hl::FuncOp fn, clang::GlobalDecl decl) {
+        const auto *function_decl = llvm::cast< clang::FunctionDecl >(decl.getDecl());
+        const auto &fty_info = type_info->arrange_global_decl(decl, get_target_info());
+
         // TODO setGVProperties
         // TODO MaubeHandleStaticInExternC
         // TODO maybeSetTrivialComdat
@@ -266,8 +436,8 @@ namespace vast::cg
         return fn;
     }
 
-    codegen_context::var_table & codegen_driver::variables_symbol_table() {
-        return codegen.variables_symbol_table();
+    symbol_table &codegen_driver::symbols() {
+        return codegen.symbols();
     }
 
 
@@ -422,7 +592,7 @@ namespace vast::cg
         return codegen.deferred_vtables();
     }
 
-    const std::map< mangled_name_ref, clang::GlobalDecl >& codegen_driver::deferred_decls() const {
+    const codegen_context::deferred_decls_map& codegen_driver::deferred_decls() const {
         return codegen.deferred_decls();
     }
 
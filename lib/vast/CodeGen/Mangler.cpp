@@ -5,10 +5,15 @@
 namespace vast::cg
 {
     mangled_name_ref CodeGenMangler::get_mangled_name(
-        clang::GlobalDecl decl, const clang::TargetInfo &target_info, const std::string &module_name_hash
+        clang::GlobalDecl decl, const clang::TargetInfo &target_info, string_ref module_name_hash
     ) {
         auto canonical = decl.getCanonicalDecl();
 
+        // Names are requested for every reference, most decls are already mangled.
+        if (auto it = mangled_decl_names.find(canonical); it != mangled_decl_names.end()) {
+            return it->second;
+        }
+
         // Some ABIs don't have constructor variants. Make sure that base and complete
         // constructors get mangled the same.
         if (const auto *ctor = clang::dyn_cast< clang::CXXConstructorDecl >(canonical.getDecl())) {
@@ -17,10 +22,12 @@ namespace vast::cg
 
         // VAST_UNIMPLEMENTED_IF(!langOpts.CUDAIsDevice);
 
-        // Keep the first result in the case of a mangling collision.
-        auto mangled_name = mangle(decl, module_name_hash);
+        llvm::SmallString< 256 > buffer;
+        llvm::raw_svector_ostream out(buffer);
+        mangle(decl, module_name_hash, out);
 
-        auto result = manglings.insert(std::make_pair(mangled_name, decl));
+        // Keep the first result in the case of a mangling collision.
+        auto result = manglings.try_emplace(buffer, decl);
         return mangled_decl_names[canonical] = mangled_name_ref{ result.first->first() };
     }
 
@@ -34,7 +41,7 @@ namespace vast::cg
 
     // Returns true if decl is a function decl with internal linkage and needs a
     // unique suffix after the mangled name.
-    static bool is_unique_internal_linkage_decl(clang::GlobalDecl /* decl */, const std::string &module_name_hash) {
+    static bool is_unique_internal_linkage_decl(clang::GlobalDecl /* decl */, string_ref module_name_hash) {
         if (!module_name_hash.empty()) {
             VAST_UNIMPLEMENTED_MSG( "Unique internal linkage names NYI");
         }
@@ -51,12 +58,11 @@ namespace vast::cg
             && decl.getKernelReferenceKind() == clang::KernelReferenceKind::Stub;
     }
 
-    std::string CodeGenMangler::mangle(clang::GlobalDecl decl, const std::string &module_name_hash) const {
+    void CodeGenMangler::mangle(
+        clang::GlobalDecl decl, string_ref module_name_hash, llvm::raw_ostream &out
+    ) const {
         const auto *named = clang::cast< clang::NamedDecl >(decl.getDecl());
 
-        llvm::SmallString< 256 > buffer;
-        llvm::raw_svector_ostream out(buffer);
-
         if (!module_name_hash.empty()) {
             VAST_UNIMPLEMENTED_MSG("mangling with uninitilized module");
         }
@@ -92,8 +98,6 @@ namespace vast::cg
         }
 
         // VAST_UNIMPLEMENTED_IF(CGM.getLangOpts().GPURelocatableDeviceCode);
-
-        return std::string(out.str());
     }
 } // namespace vast::cg
 
@@ -14,7 +14,8 @@ VAST_UNRELAX_WARNINGS
 namespace vast::cg {
 
     logical_result emit_high_level_pass(
-        vast_module mod, mcontext_t *mctx, acontext_t */* actx */, bool enable_verifier
+        vast_module mod, mcontext_t *mctx, acontext_t */* actx */, bool enable_verifier,
+        llvm::function_ref< void(mlir::PassManager &) > hook
     ) {
         mlir::PassManager mgr(mctx);
 
@@ -22,6 +23,9 @@ namespace vast::cg {
         mgr.addPass(hl::createSpliceTrailingScopes());
 
         mgr.enableVerifier(enable_verifier);
+        if (hook) {
+            hook(mgr);
+        }
         return mgr.run(mod);
     }
 
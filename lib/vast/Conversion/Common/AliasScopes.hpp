@@ -0,0 +1,148 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/Dialect/LLVMIR/LLVMDialect.h>
+
+#include <llvm/ADT/MapVector.h>
+#include <llvm/Support/FormatVariadic.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
+
+#include "vast/Util/Common.hpp"
+
+namespace vast::conv::irstollvm
+{
+    // Slots of `restrict` qualified parameters spilled to their allocas are
+    // marked with this attribute while the conversion runs. Once the whole
+    // module is in the llvm dialect, every function gets its own alias scope
+    // domain with one scope per marked slot and the marker is dropped again.
+    //
+    // Restrict locals get no scope: a restrict pointer declared in a nested
+    // block may be based on an outer one (C11 6.7.3.1p11) and restrict locals
+    // of disjoint blocks may point to the same object, which a function wide
+    // scope cannot express. The same way clang only emits `noalias` for
+    // parameters.
+    static constexpr llvm::StringLiteral restrict_slot_attr_name = "vast.restrict_slot";
+
+    static inline bool is_restrict_ptr(mlir_type type)
+    {
+        if (auto lvalue = mlir::dyn_cast< hl::LValueType >(type))
+            type = lvalue.getElementType();
+        if (auto decayed = mlir::dyn_cast< hl::DecayedType >(type))
+            type = decayed.getElementType();
+
+        auto ptr = mlir::dyn_cast< hl::PointerType >(type);
+        return ptr && ptr.getQuals() && ptr.getQuals().hasRestrict();
+    }
+
+    static inline void mark_restrict_slot(mlir::LLVM::AllocaOp slot)
+    {
+        slot->setAttr(restrict_slot_attr_name, mlir::UnitAttr::get(slot.getContext()));
+    }
+
+    struct alias_scope_builder
+    {
+        using domain_t = mlir::LLVM::AliasScopeDomainAttr;
+        using scope_t  = mlir::LLVM::AliasScopeAttr;
+
+        mlir::LLVM::LLVMFuncOp fn;
+        llvm::MapVector< operation, scope_t > scopes = {};
+
+        // Returns the restrict slot the pointer `addr` was loaded from, looking
+        // through address arithmetic. Accesses through pointers that were stored
+        // to memory and reloaded are not based on the slot.
+        static mlir::LLVM::AllocaOp based_on(mlir_value addr)
+        {
+            while (addr) {
+                auto def = addr.getDefiningOp();
+                if (!def)
+                    return {};
+
+                if (auto gep = mlir::dyn_cast< mlir::LLVM::GEPOp >(def)) {
+                    addr = gep.getBase();
+                } else if (auto cast = mlir::dyn_cast< mlir::LLVM::BitcastOp >(def)) {
+                    addr = cast.getArg();
+                } else if (auto load = mlir::dyn_cast< mlir::LLVM::LoadOp >(def)) {
+                    auto slot = load.getAddr().getDefiningOp< mlir::LLVM::AllocaOp >();
+                    if (slot && slot->hasAttr(restrict_slot_attr_name))
+                        return slot;
+                    return {};
+                } else {
+                    return {};
+                }
+            }
+            return {};
+        }
+
+        // The parameter keeps the value it was called with if its slot is
+        // stored to only by the spill and its address does not escape.
+        static bool holds_argument(mlir::LLVM::AllocaOp slot)
+        {
+            std::size_t stores = 0;
+            for (auto user : slot->getUsers()) {
+                if (mlir::isa< mlir::LLVM::LoadOp >(user))
+                    continue;
+
+                auto store = mlir::dyn_cast< mlir::LLVM::StoreOp >(user);
+                if (!store || store.getValue() == slot.getResult())
+                    return false;
+                ++stores;
+            }
+            return stores == 1;
+        }
+
+        void collect_scopes()
+        {
+            auto ctx    = fn.getContext();
+            auto domain = domain_t::get(ctx, mlir::StringAttr::get(ctx, fn.getName()));
+
+            fn.walk([&](mlir::LLVM::AllocaOp slot) {
+                if (!slot->hasAttr(restrict_slot_attr_name))
+                    return;
+                if (!holds_argument(slot)) {
+                    slot->removeAttr(restrict_slot_attr_name);
+                    return;
+                }
+                auto name = llvm::formatv("{0}: restrict #{1}", fn.getName(), scopes.size());
+                scopes[slot] = scope_t::get(domain, mlir::StringAttr::get(ctx, name.str()));
+            });
+        }
+
+        void annotate(auto mem_op)
+        {
+            auto slot = based_on(mem_op.getAddr());
+            if (!slot)
+                return;
+
+            auto ctx = fn.getContext();
+            llvm::SmallVector< mlir::Attribute > noalias;
+            for (const auto &[other, scope] : scopes) {
+                if (other != slot.getOperation())
+                    noalias.push_back(scope);
+            }
+
+            mem_op.setAliasScopesAttr(mlir::ArrayAttr::get(ctx, { scopes.lookup(slot) }));
+            if (!noalias.empty())
+                mem_op.setNoaliasScopesAttr(mlir::ArrayAttr::get(ctx, noalias));
+        }
+
+        void run()
+        {
+            collect_scopes();
+
+            if (!scopes.empty()) {
+                fn.walk([&](mlir::LLVM::LoadOp op) { annotate(op); });
+                fn.walk([&](mlir::LLVM::StoreOp op) { annotate(op); });
+            }
+
+            for (auto &[slot, _] : scopes)
+                slot->removeAttr(restrict_slot_attr_name);
+        }
+    };
+
+} // namespace vast::conv::irstollvm
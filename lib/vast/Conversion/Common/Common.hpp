@@ -9,6 +9,8 @@
 #include "vast/Conversion/Common/Patterns.hpp"
 #include "vast/Conversion/TypeConverters/LLVMTypeConverter.hpp"
 
+#include "TBAA.hpp"
+
 namespace vast::conv::irstollvm {
     // I would consider to just use the entire namespace, everything
     // has (unfortunately) prefixed name with `LLVM` anyway.
@@ -27,6 +29,12 @@ namespace vast::conv::irstollvm {
 
         auto dl(auto op) const { return tc.getDataLayoutAnalysis()->getAtOrAbove(op); }
 
+        // Attach type-based alias information to the memory access `mem_op` of
+        // `type`, `addr` is the original address of the access if available.
+        void annotate_access(auto mem_op, mlir_type type, mlir_value addr = {}) const {
+            tbaa_builder{ mem_op->getContext(), dl(mem_op), tc }.annotate(mem_op, type, addr);
+        }
+
         auto mk_alloca(auto &rewriter, mlir_type trg_type, auto loc) const {
             auto count = rewriter.template create< LLVM::ConstantOp >(
                 loc, type_converter().convertType(rewriter.getIndexType()),
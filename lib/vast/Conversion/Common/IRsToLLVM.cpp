@@ -19,6 +19,7 @@ VAST_UNRELAX_WARNINGS
 #include "vast/Dialect/HighLevel/HighLevelAttributes.hpp"
 #include "vast/Dialect/HighLevel/HighLevelOps.hpp"
 #include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
+#include "vast/Dialect/HighLevel/Passes.hpp"
 
 #include "vast/Dialect/Core/CoreAttributes.hpp"
 
@@ -35,6 +36,7 @@ VAST_UNRELAX_WARNINGS
 #include "vast/Conversion/Common/Passes.hpp"
 #include "vast/Conversion/TypeConverters/LLVMTypeConverter.hpp"
 
+#include "AliasScopes.hpp"
 #include "Common.hpp"
 #include "LLCFToLLVM.hpp"
 
@@ -180,10 +182,36 @@ namespace vast::conv::irstollvm
         }
     };
 
+    template< typename op_t, typename marker_t >
+    struct ll_lifetime_marker : base_pattern< op_t >
+    {
+        using base = base_pattern< op_t >;
+        using base::base;
+
+        logical_result matchAndRewrite(
+            op_t op, typename op_t::Adaptor ops, conversion_rewriter &rewriter
+        ) const override {
+            auto ptr = mlir::dyn_cast< mlir::LLVM::LLVMPointerType >(ops.getVar().getType());
+            VAST_PATTERN_CHECK(ptr, "Lifetime marker of a non-pointer: {0}", ops.getVar());
+
+            // Size of -1 stands for the whole object.
+            auto size = ptr.getElementType()
+                ? static_cast< std::int64_t >(this->dl(op).getTypeSize(ptr.getElementType()))
+                : -1;
+
+            rewriter.replaceOpWithNewOp< marker_t >(
+                op, rewriter.getI64IntegerAttr(size), ops.getVar()
+            );
+            return mlir::success();
+        }
+    };
+
     using ll_generic_patterns = util::type_list<
         ll_struct_gep,
         ll_extract,
-        ll_concat
+        ll_concat,
+        ll_lifetime_marker< ll::LifetimeStart, mlir::LLVM::LifetimeStartOp >,
+        ll_lifetime_marker< ll::LifetimeEnd, mlir::LLVM::LifetimeEndOp >
     >;
 
     template< typename Op >
@@ -313,10 +341,11 @@ namespace vast::conv::irstollvm
 
             // We know it must be only one if the type is scalar.
             auto element = ops.getElements()[0];
-            rewriter.template create< LLVM::StoreOp >(
+            auto store = rewriter.template create< LLVM::StoreOp >(
                     element.getLoc(),
                     element,
                     ptr);
+            this->annotate_access(store, element.getType());
         }
 
         void handle_init_list(auto init_list, auto ptr, auto &rewriter) const
@@ -331,8 +360,12 @@ namespace vast::conv::irstollvm
 
                 if (auto nested = mlir::dyn_cast< hl::InitListExpr >(element.getDefiningOp()))
                     handle_init_list(nested, gep, rewriter);
-                else
-                    rewriter.template create< LLVM::StoreOp >(element.getLoc(), element, gep);
+                else {
+                    auto store = rewriter.template create< LLVM::StoreOp >(
+                        element.getLoc(), element, gep
+                    );
+                    this->annotate_access(store, element.getType());
+                }
             }
             erase(init_list, rewriter);
         }
@@ -378,12 +411,48 @@ namespace vast::conv::irstollvm
         }
     };
 
+    // Lowers dense initializers outside of global initializers, e.g., of
+    // static local variables.
+    struct dense_init_list_expr : base_pattern< hl::DenseInitListExpr >
+    {
+        using op_t = hl::DenseInitListExpr;
+        using base = base_pattern< op_t >;
+        using base::base;
+
+        logical_result matchAndRewrite(
+                op_t op, typename op_t::Adaptor ops,
+                conversion_rewriter &rewriter) const override
+        {
+            auto target_type = this->convert(op.getType());
+            VAST_PATTERN_CHECK(target_type, "Failed conversion of DenseInitListExpr type");
+            rewriter.replaceOpWithNewOp< LLVM::ConstantOp >(op, target_type, op.getValue());
+            return logical_result::success();
+        }
+    };
+
     struct vardecl : base_pattern< hl::VarDeclOp >
     {
         using op_t = hl::VarDeclOp;
         using base = base_pattern< op_t >;
         using base::base;
 
+        // Initializer consisting only of a dense constant.
+        static mlir::Attribute dense_initializer(op_t op)
+        {
+            auto &init = op.getInitializer();
+            if (!init.hasOneBlock())
+                return {};
+
+            auto yield = terminator_t< hl::ValueYieldOp >::get(init.front());
+            if (!yield)
+                return {};
+
+            auto dense = yield.op().getResult().getDefiningOp< hl::DenseInitListExpr >();
+            if (!dense || &init.front().front() != dense.getOperation())
+                return {};
+            return dense.getValue();
+        }
+
         logical_result matchAndRewrite(
                 op_t op, typename op_t::Adaptor ops,
                 conversion_rewriter &rewriter) const override
@@ -391,6 +460,21 @@ namespace vast::conv::irstollvm
             auto t = mlir::dyn_cast< hl::LValueType >(op.getType());
             auto target_type = this->convert(t.getElementType());
 
+            // Constness is marked by type lowering, unmarked globals are
+            // conservatively kept writable.
+            bool constant = op->hasAttr(core::CoreDialect::getConstantAttrName());
+
+            if (auto dense = dense_initializer(op)) {
+                rewriter.create< mlir::LLVM::GlobalOp >(
+                        op.getLoc(),
+                        target_type,
+                        constant,
+                        LLVM::Linkage::Internal,
+                        op.getName(), dense);
+                rewriter.eraseOp(op);
+                return logical_result::success();
+            }
+
             // Sadly, we cannot build `mlir::LLVM::GlobalOp` without
             // providing a value attribute.
             auto dummy_value = rewriter.getIntegerAttr(target_type, 0);
@@ -399,8 +483,7 @@ namespace vast::conv::irstollvm
             auto gop = rewriter.create< mlir::LLVM::GlobalOp >(
                     op.getLoc(),
                     target_type,
-                    // TODO(conv:irstollvm): Constant.
-                    true,
+                    constant,
                     LLVM::Linkage::Internal,
                     op.getName(), dummy_value);
 
@@ -445,6 +528,7 @@ namespace vast::conv::irstollvm
         uninit_var,
         initialize_var,
         init_list_expr,
+        dense_init_list_expr,
         vardecl,
         global_ref
     >;
@@ -491,7 +575,19 @@ namespace vast::conv::irstollvm
             rewriter.inlineRegionBefore(func_op.getBody(), new_func.getBody(), new_func.end());
             tc::convert_region_types(func_op, new_func, signature);
 
-            if (mlir::failed(args_to_allocas(new_func, rewriter))) {
+            // `restrict` qualified parameters are the only pointers into their
+            // objects for the duration of the call.
+            llvm::SmallVector< bool > restrict_args;
+            for (auto [idx, arg_type] : llvm::enumerate(func_op.getFunctionType().getInputs())) {
+                restrict_args.push_back(is_restrict_ptr(arg_type));
+                if (restrict_args.back()) {
+                    new_func.setArgAttr(
+                        idx, LLVM::LLVMDialect::getNoAliasAttrName(), rewriter.getUnitAttr()
+                    );
+                }
+            }
+
+            if (mlir::failed(args_to_allocas(new_func, restrict_args, rewriter))) {
                 VAST_PATTERN_FAIL("Failed to convert func arguments");
             }
             rewriter.eraseOp(func_op);
@@ -500,6 +596,7 @@ namespace vast::conv::irstollvm
 
         logical_result args_to_allocas(
                 mlir::LLVM::LLVMFuncOp fn,
+                llvm::ArrayRef< bool > restrict_args,
                 conversion_rewriter &rewriter) const
         {
             // TODO(lukas): Missing support in hl.
@@ -516,9 +613,12 @@ namespace vast::conv::irstollvm
             mlir::OpBuilder::InsertionGuard guard(rewriter);
             rewriter.setInsertionPointToStart(&block);
 
-            for (auto arg : block.getArguments())
-                if (mlir::failed(arg_to_alloca(arg, block, rewriter)))
+            for (auto arg : block.getArguments()) {
+                auto is_restrict = arg.getArgNumber() < restrict_args.size()
+                                && restrict_args[arg.getArgNumber()];
+                if (mlir::failed(arg_to_alloca(arg, block, is_restrict, rewriter)))
                     return logical_result::failure();
+            }
 
             return logical_result::success();
         }
@@ -526,7 +626,7 @@ namespace vast::conv::irstollvm
         // TODO(lukas): Extract common codebase (there will be other places
         //              that need to create allocas).
         logical_result arg_to_alloca(mlir::BlockArgument arg, mlir::Block &block,
-                                          conversion_rewriter &rewriter) const
+                                     bool is_restrict, conversion_rewriter &rewriter) const
         {
             auto ptr_type = mlir::LLVM::LLVMPointerType::get(arg.getType());
             if (!ptr_type)
@@ -539,6 +639,8 @@ namespace vast::conv::irstollvm
 
             auto alloca_op = rewriter.create< LLVM::AllocaOp >(
                     arg.getLoc(), ptr_type, count, 0);
+            if (is_restrict)
+                mark_restrict_slot(alloca_op);
 
             arg.replaceAllUsesWith(alloca_op);
             rewriter.create< mlir::LLVM::StoreOp >(arg.getLoc(), arg, alloca_op);
@@ -728,7 +830,8 @@ namespace vast::conv::irstollvm
         };
 
         auto lvalue_to_rvalue = [&] {
-            rewriter.template replaceOpWithNewOp< LLVM::LoadOp >(op, dst_type, src);
+            auto load = rewriter.template replaceOpWithNewOp< LLVM::LoadOp >(op, dst_type, src);
+            pattern.annotate_access(load, orig_dst_type, op.getValue());
             return mlir::success();
         };
 
@@ -1016,6 +1119,7 @@ namespace vast::conv::irstollvm
                 return logical_result::failure();
 
             auto load_lhs = rewriter.create< LLVM::LoadOp >(op.getLoc(), lhs);
+            this->annotate_access(load_lhs, op.getType(), op.getDst());
             auto target_ty = this->convert(op.getSrc().getType());
 
             // Probably the easiest way to compose this (some template specialization would
@@ -1028,7 +1132,8 @@ namespace vast::conv::irstollvm
                     return rhs;
             }();
 
-            rewriter.create< LLVM::StoreOp >(op.getLoc(), new_op, lhs);
+            auto store = rewriter.create< LLVM::StoreOp >(op.getLoc(), new_op, lhs);
+            this->annotate_access(store, op.getType(), op.getDst());
 
             // `hl.assign` returns value for cases like `int x = y = 5;`
             rewriter.replaceOp(op, new_op);
@@ -1075,6 +1180,9 @@ namespace vast::conv::irstollvm
                     hl::CallOp op, typename hl::CallOp::Adaptor ops,
                     conversion_rewriter &rewriter) const override
         {
+            if (op.getCallee() == hl::profile::runtime::increment_name)
+                return lower_profile_increment(op, ops, rewriter);
+
             auto module = op->getParentOfType< mlir::ModuleOp >();
             if (!module)
                 return logical_result::failure();
@@ -1107,6 +1215,28 @@ namespace vast::conv::irstollvm
 
             return logical_result::success();
         }
+
+        // Profile counters are incremented inline, the marker call only names
+        // the counter array and the slot.
+        logical_result lower_profile_increment(
+                    hl::CallOp op, typename hl::CallOp::Adaptor ops,
+                    conversion_rewriter &rewriter) const
+        {
+            auto operands = ops.getOperands();
+            if (operands.size() != 2)
+                return logical_result::failure();
+
+            auto counters = operands[0];
+            auto slot = rewriter.create< LLVM::GEPOp >(
+                    op.getLoc(), counters.getType(), counters, operands[1]);
+            auto one = rewriter.create< LLVM::ConstantOp >(
+                    op.getLoc(), rewriter.getI64Type(), rewriter.getI64IntegerAttr(1));
+            rewriter.create< LLVM::AtomicRMWOp >(
+                    op.getLoc(), LLVM::AtomicBinOp::add, slot, one,
+                    LLVM::AtomicOrdering::monotonic);
+            rewriter.eraseOp(op);
+            return logical_result::success();
+        }
     };
 
     bool is_lvalue(auto op)
@@ -1144,10 +1274,12 @@ namespace vast::conv::irstollvm
                 return logical_result::failure();
 
             auto value = rewriter.create< LLVM::LoadOp >(op.getLoc(), arg);
+            this->annotate_access(value, op.getType(), op.getArg());
             auto one = this->constant(rewriter, op.getLoc(), value.getType(), 1);
             auto adjust = rewriter.create< Trg >(op.getLoc(), value, one);
 
-            rewriter.create< LLVM::StoreOp >(op.getLoc(), adjust, arg);
+            auto store = rewriter.create< LLVM::StoreOp >(op.getLoc(), adjust, arg);
+            this->annotate_access(store, op.getType(), op.getArg());
 
             auto yielded = [&]() {
                 if constexpr (prefix_yield< YieldAt >())
@@ -1325,6 +1457,8 @@ namespace vast::conv::irstollvm
 
             auto loaded = rewriter.create< mlir::LLVM::LoadOp >(
                     op.getLoc(), *trg_type, ops.getAddr());
+            // The loaded value is the dereferenced pointer itself.
+            this->annotate_access(loaded, *trg_type);
             rewriter.replaceOp(op, loaded);
 
             return logical_result::success();
@@ -1477,10 +1611,33 @@ namespace vast::conv::irstollvm
         }
     };
 
+    // `core.select` yields no value if both of its sides are `void`.
+    struct select_op_type : base_pattern< core::SelectOp >
+    {
+        using op_t = core::SelectOp;
+        using base = base_pattern< op_t >;
+        using base::base;
+
+        logical_result matchAndRewrite(
+            op_t op, typename op_t::Adaptor ops,
+            conversion_rewriter &rewriter) const override
+        {
+            auto lower_res_types = [&]()
+            {
+                for (auto result : op.getResults())
+                    result.setType(this->convert(result.getType()));
+            };
+
+            rewriter.updateRootInPlace(op, lower_res_types);
+            return logical_result::success();
+        }
+    };
+
     using lazy_op_type_conversions = util::type_list<
         lazy_op_type< core::LazyOp >,
         lazy_op_type< core::BinLAndOp >,
         lazy_op_type< core::BinLOrOp >,
+        select_op_type,
         fixup_yield_types< hl::ValueYieldOp >
     >;
 
@@ -1506,6 +1663,12 @@ namespace vast::conv::irstollvm
             legal_with_llvm_ret_type( core::BinLOrOp{} );
             legal_with_llvm_ret_type( hl::ValueYieldOp{} );
 
+            target.addDynamicallyLegalOp< core::SelectOp >([&](core::SelectOp op) {
+                return llvm::none_of(op.getResultTypes(), [&](mlir_type type) {
+                    return contains_subtype(type, get_is_illegal(tc));
+                });
+            });
+
 
             target.addDynamicallyLegalOp< hl::InitListExpr >(
                 get_has_only_legal_types< hl::InitListExpr >(tc)
@@ -1539,6 +1702,37 @@ namespace vast::conv::irstollvm
             llvm_options.useBarePtrCallConv = true;
         }
 
+        // Instrumented modules register their counters with the profiling
+        // runtime from a constructor, the increment marker is gone by now.
+        void register_profile_init() {
+            auto mod = this->getOperation();
+            if (auto inc = mod.lookupSymbol< LLVM::LLVMFuncOp >(
+                    hl::profile::runtime::increment_name)) {
+                if (mlir::SymbolTable::symbolKnownUseEmpty(inc, mod))
+                    inc.erase();
+            }
+
+            auto init = mod.lookupSymbol< LLVM::LLVMFuncOp >(
+                hl::profile::runtime::init_name);
+            if (!init)
+                return;
+
+            init.setLinkage(LLVM::Linkage::Internal);
+
+            auto bld = mlir::OpBuilder::atBlockEnd(mod.getBody());
+            bld.create< LLVM::GlobalCtorsOp >(
+                init.getLoc(),
+                bld.getArrayAttr({ mlir::FlatSymbolRefAttr::get(init.getSymNameAttr()) }),
+                bld.getI32ArrayAttr({ 65535 })
+            );
+        }
+
+        void after_operation() override {
+            this->getOperation().walk([](mlir::LLVM::LLVMFuncOp fn) {
+                alias_scope_builder{ fn }.run();
+            });
+            register_profile_init();
+        }
     };
 } // namespace vast::conv
 
@@ -57,7 +57,35 @@ namespace vast::conv::irstollvm::ll_cf
                 op.getLoc(),
                 ops.getCond(),
                 op.getTrueDest() , ops.getTrueOperands(),
-                op.getFalseDest(), ops.getFalseOperands()
+                op.getFalseDest(), ops.getFalseOperands(),
+                this->cond_branch_weights(op)
+            );
+            rewriter.eraseOp( op );
+
+            return mlir::success();
+        }
+
+    };
+
+    struct switch_op : base_pattern< ll::Switch >
+    {
+        using base = base_pattern< ll::Switch >;
+        using base::base;
+
+        using op_t = ll::Switch;
+        using adaptor_t = typename op_t::Adaptor;
+
+        logical_result matchAndRewrite(
+            op_t op, adaptor_t ops,
+            conversion_rewriter &rewriter) const override
+        {
+            auto values = op.getCaseValues().value_or(mlir::DenseIntElementsAttr());
+            rewriter.create< LLVM::SwitchOp >(
+                op.getLoc(),
+                ops.getCond(),
+                op.getDefaultDest(), mlir::ValueRange(),
+                values, op.getCaseDests(),
+                llvm::ArrayRef< mlir::ValueRange >(), this->branch_weights(op)
             );
             rewriter.eraseOp( op );
 
@@ -94,7 +122,8 @@ namespace vast::conv::irstollvm::ll_cf
                 make_after_op< LLVM::CondBrOp >(rewriter, &last, last.getLoc(),
                                                 ret.getCond(),
                                                 ret.getDest(), ret.getDestOperands(),
-                                                &end, no_vals);
+                                                &end, no_vals,
+                                                this->cond_branch_weights(ret));
             } else {
                 // Nothing to do (do not erase, since it is a standard branching).
                 return mlir::success();
@@ -172,6 +201,7 @@ namespace vast::conv::irstollvm::ll_cf
     using conversions = util::type_list<
           cond_br
         , br
+        , switch_op
         , scope
     >;
 
@@ -0,0 +1,222 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/Dialect/LLVMIR/LLVMDialect.h>
+#include <mlir/Interfaces/DataLayoutInterfaces.h>
+
+#include <llvm/Support/MathExtras.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/Core/CoreDialect.hpp"
+#include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
+#include "vast/Dialect/LowLevel/LowLevelOps.hpp"
+
+#include "vast/Conversion/TypeConverters/LLVMTypeConverter.hpp"
+
+#include "vast/Util/Common.hpp"
+
+namespace vast::conv::irstollvm
+{
+    // Builds type-based alias analysis tags the same way clang does, for modules
+    // marked with the strict aliasing attribute:
+    //  * every scalar type descriptor is a child of "omnipotent char", therefore
+    //    character accesses alias everything,
+    //  * signed and unsigned variants of a type share one descriptor,
+    //  * all pointers are described as "any pointer",
+    //  * accesses to structure members use struct-path tags, with member offsets
+    //    computed from the data layout.
+    // Types are not always fully lowered at this point (structure bodies still
+    // refer to builtin signed integers for example), so the descriptors are
+    // derived from widths rather than from the exact types.
+    struct tbaa_builder
+    {
+        mcontext_t *mctx;
+        mlir::DataLayout dl;
+        tc::FullLLVMTypeConverter &tc;
+
+        using tag_t         = mlir::LLVM::TBAATagAttr;
+        using descriptor_t  = mlir::LLVM::TBAATypeDescriptorAttr;
+        using member_t      = mlir::LLVM::TBAAMemberAttr;
+        using struct_type_t = mlir::LLVM::LLVMStructType;
+
+        static bool is_enabled(operation op)
+        {
+            auto mod = op->getParentOfType< vast_module >();
+            return mod && mod->hasAttr(core::CoreDialect::getStrictAliasingAttrName());
+        }
+
+        mlir::LLVM::TBAARootAttr root() const
+        {
+            return mlir::LLVM::TBAARootAttr::get(
+                mctx, mlir::StringAttr::get(mctx, "Simple C/C++ TBAA")
+            );
+        }
+
+        descriptor_t omnipotent_char() const
+        {
+            return descriptor_t::get(mctx, "omnipotent char", member_t::get(mctx, root(), 0));
+        }
+
+        static mlir_type strip_lvalue(mlir_type type)
+        {
+            if (auto lvalue = mlir::dyn_cast< hl::LValueType >(type))
+                return lvalue.getElementType();
+            return type;
+        }
+
+        static std::optional< llvm::StringRef > scalar_name(mlir_type type)
+        {
+            if (mlir::isa< hl::PointerType, mlir::LLVM::LLVMPointerType >(type))
+                return "any pointer";
+
+            if (auto int_type = mlir::dyn_cast< mlir::IntegerType >(type)) {
+                switch (int_type.getWidth()) {
+                    case 1:   return "_Bool";
+                    case 8:   return "omnipotent char";
+                    case 16:  return "short";
+                    case 32:  return "int";
+                    case 64:  return "long";
+                    case 128: return "__int128";
+                    default:  return std::nullopt;
+                }
+            }
+
+            if (type.isF16())
+                return "_Float16";
+            if (type.isF32())
+                return "float";
+            if (type.isF64())
+                return "double";
+            if (type.isF80() || type.isF128())
+                return "long double";
+            return std::nullopt;
+        }
+
+        descriptor_t scalar_descriptor(mlir_type type) const
+        {
+            auto name = scalar_name(strip_lvalue(type));
+            if (!name)
+                return {};
+
+            auto char_desc = omnipotent_char();
+            if (*name == char_desc.getId())
+                return char_desc;
+            return descriptor_t::get(mctx, *name, member_t::get(mctx, char_desc, 0));
+        }
+
+        static struct_type_t as_struct(mlir_type type)
+        {
+            type = strip_lvalue(type);
+            if (auto ptr = mlir::dyn_cast< hl::PointerType >(type))
+                type = ptr.getElementType();
+            if (auto ptr = mlir::dyn_cast< mlir::LLVM::LLVMPointerType >(type))
+                type = ptr.getElementType();
+
+            auto st = mlir::dyn_cast_or_null< struct_type_t >(type);
+            if (!st || !st.isIdentified() || st.isOpaque())
+                return {};
+            return st;
+        }
+
+        std::optional< std::uint64_t > field_offset(struct_type_t type, unsigned idx) const
+        {
+            std::uint64_t offset = 0;
+            for (auto [i, field] : llvm::enumerate(type.getBody())) {
+                auto llvm_type = tc.convert_type_to_type(field);
+                if (!llvm_type)
+                    return std::nullopt;
+
+                if (!type.isPacked())
+                    offset = llvm::alignTo(offset, dl.getTypeABIAlignment(*llvm_type));
+                if (i == idx)
+                    return offset;
+                offset += dl.getTypeSize(*llvm_type);
+            }
+            return std::nullopt;
+        }
+
+        // Members that are neither scalars nor structures (arrays, unions) are
+        // described conservatively as characters.
+        descriptor_t member_descriptor(mlir_type type) const
+        {
+            if (auto st = as_struct(type); st && st == type)
+                return struct_descriptor(st);
+            if (auto desc = scalar_descriptor(type))
+                return desc;
+            return omnipotent_char();
+        }
+
+        descriptor_t struct_descriptor(struct_type_t type) const
+        {
+            llvm::SmallVector< member_t > members;
+            for (auto [idx, field] : llvm::enumerate(type.getBody())) {
+                auto desc = member_descriptor(field);
+                auto offset = field_offset(type, idx);
+                if (!desc || !offset)
+                    return {};
+                members.push_back(member_t::get(mctx, desc, *offset));
+            }
+            return descriptor_t::get(mctx, type.getName(), members);
+        }
+
+        // Access through a chain of `ll.gep` operations is described relative to
+        // the outermost structure.
+        tag_t struct_path_tag(mlir_value addr, descriptor_t access) const
+        {
+            auto gep = addr.getDefiningOp< ll::StructGEPOp >();
+            if (!gep)
+                return {};
+
+            auto record = as_struct(gep.getRecord().getType());
+            if (!record || gep.getIdx() >= record.getBody().size())
+                return {};
+            if (scalar_descriptor(record.getBody()[gep.getIdx()]) != access)
+                return {};
+
+            std::uint64_t offset = 0;
+            struct_type_t base;
+            for (; gep; gep = gep.getRecord().getDefiningOp< ll::StructGEPOp >()) {
+                base = as_struct(gep.getRecord().getType());
+                if (!base)
+                    return {};
+                auto field_off = field_offset(base, gep.getIdx());
+                if (!field_off)
+                    return {};
+                offset += *field_off;
+            }
+
+            auto base_desc = struct_descriptor(base);
+            if (!base_desc)
+                return {};
+            return tag_t::get(mctx, base_desc, access, offset, false);
+        }
+
+        // `addr` is the original (not yet converted) address of the access.
+        tag_t tag(mlir_type type, mlir_value addr) const
+        {
+            auto access = scalar_descriptor(type);
+            if (!access)
+                return {};
+
+            if (addr) {
+                if (auto path = struct_path_tag(addr, access))
+                    return path;
+            }
+
+            return tag_t::get(mctx, access, access, 0, false);
+        }
+
+        void annotate(auto mem_op, mlir_type type, mlir_value addr = {}) const
+        {
+            if (!is_enabled(mem_op))
+                return;
+            if (auto access_tag = tag(type, addr))
+                mem_op.setTbaaAttr(mlir::ArrayAttr::get(mctx, { access_tag }));
+        }
+    };
+
+} // namespace vast::conv::irstollvm
@@ -8,6 +8,7 @@ VAST_RELAX_WARNINGS
 #include <mlir/Transforms/GreedyPatternRewriteDriver.h>
 #include <mlir/Transforms/DialectConversion.h>
 #include <mlir/IR/IRMapping.h>
+#include <mlir/Interfaces/SideEffectInterfaces.h>
 VAST_UNRELAX_WARNINGS
 
 #include <iterator>
@@ -17,6 +18,7 @@ VAST_UNRELAX_WARNINGS
 #include "vast/Conversion/Common/Patterns.hpp"
 
 #include "vast/Dialect/Core/CoreOps.hpp"
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
 
 #include "vast/Util/Common.hpp"
 #include "vast/Util/TypeList.hpp"
@@ -29,11 +31,73 @@ namespace vast
         namespace LLVM = mlir::LLVM;
 
 
+        // Lazy operands that are cheap to evaluate and cannot trap or have side
+        // effects are evaluated unconditionally, so that the result can be
+        // combined without branching.
+        struct speculation_cost_model
+        {
+            // Maximal number of (non-constant) operations of a speculated operand.
+            unsigned threshold;
+
+            static bool is_speculatable(Operation *op)
+            {
+                if (op->getNumRegions() != 0)
+                    return false;
+
+                // Arithmetic operations are pure in the llvm dialect, division
+                // by zero is undefined behaviour nevertheless.
+                if (mlir::isa< LLVM::SDivOp, LLVM::UDivOp, LLVM::SRemOp, LLVM::URemOp >(op))
+                    return false;
+
+                // Reading a local variable never traps.
+                if (auto load = mlir::dyn_cast< LLVM::LoadOp >(op))
+                    return !load.getVolatile_() && load.getAddr().getDefiningOp< LLVM::AllocaOp >();
+
+                return mlir::isPure(op);
+            }
+
+            bool is_cheap(Operation *lazy_op) const
+            {
+                auto lazy = mlir::dyn_cast_or_null< core::LazyOp >(lazy_op);
+                if (!lazy || !lazy.getLazy().hasOneBlock())
+                    return false;
+
+                unsigned cost = 0;
+                for (auto &op : lazy.getLazy().front()) {
+                    if (mlir::isa< hl::ValueYieldOp >(op))
+                        continue;
+                    if (!is_speculatable(&op))
+                        return false;
+                    if (!mlir::isa< LLVM::ConstantOp >(op) && ++cost > threshold)
+                        return false;
+                }
+                return true;
+            }
+        };
+
         template< typename Op >
         struct lazy_base : operation_conversion_pattern< Op >, llvm_pattern_utils
         {
             using base = operation_conversion_pattern< Op >;
-            using base::base;
+
+            speculation_cost_model cost_model;
+
+            lazy_base(mcontext_t *mctx, unsigned threshold)
+                : base(mctx), cost_model{ threshold }
+            {}
+
+            // Removes the yield of the lazy region and returns the yielded value,
+            // `void` regions yield nothing.
+            static Value take_result(mlir::Region &lazy_region, conversion_rewriter &rewriter)
+            {
+                auto yield = mlir::dyn_cast< hl::ValueYieldOp >(lazy_region.back().back());
+                if (!yield)
+                    return {};
+
+                auto res = yield.getResult();
+                rewriter.eraseOp(yield);
+                return res;
+            }
 
             auto lazy_into_block(
                 Operation* lazy_op, Block* target, conversion_rewriter &rewriter) const
@@ -41,9 +105,7 @@ namespace vast
                 auto &lazy_region = dyn_cast< core::LazyOp >(*lazy_op).getLazy();
 
                 // Last block should have hl.value.yield with the final value
-                auto &yield = lazy_region.back().back();
-                auto res = dyn_cast< hl::ValueYieldOp>(yield).getResult();
-                rewriter.eraseOp(&yield);
+                auto res = take_result(lazy_region, rewriter);
 
                 auto &first_block = lazy_region.front();
                 // The rewriter API doesn't provide a call to insert into a selected block
@@ -57,6 +119,32 @@ namespace vast
 
                 return res;
             }
+
+            // Evaluates a single block lazy region unconditionally right before `op`.
+            auto lazy_inline(
+                Operation *lazy_op, Operation *op, conversion_rewriter &rewriter) const
+            {
+                auto &lazy_region = dyn_cast< core::LazyOp >(*lazy_op).getLazy();
+                auto res = take_result(lazy_region, rewriter);
+
+                rewriter.inlineBlockBefore(&lazy_region.front(), op, std::nullopt);
+                rewriter.eraseOp(lazy_op);
+
+                return res;
+            }
+
+            Value to_i1(conversion_rewriter &rewriter, auto loc, Value value) const
+            {
+                if (value.getType().isInteger(1))
+                    return value;
+
+                auto zero = mlir::isa< LLVM::LLVMPointerType >(value.getType())
+                    ? null_ptr(rewriter, loc, value.getType())
+                    : iN(rewriter, loc, value.getType(), 0);
+                return rewriter.create< LLVM::ICmpOp >(
+                    loc, LLVM::ICmpPredicate::ne, value, zero
+                );
+            }
         };
 
         template< typename LOp, bool short_on_true >
@@ -78,9 +166,44 @@ namespace vast
                 }
             }
 
+            logical_result speculate(
+                LOp op, adaptor_t ops, conversion_rewriter &rewriter) const
+            {
+                auto lhs_res = this->lazy_inline(ops.getLhs().getDefiningOp(), op, rewriter);
+                auto rhs_res = this->lazy_inline(ops.getRhs().getDefiningOp(), op, rewriter);
+
+                auto lhs = this->to_i1(rewriter, op.getLoc(), lhs_res);
+                auto rhs = this->to_i1(rewriter, op.getLoc(), rhs_res);
+
+                // The right hand side may be poison when the left hand side
+                // short circuits, e.g. `n < 32 && (x << n)`. Unlike `llvm.and`
+                // and `llvm.or`, select does not propagate poison of the
+                // operand it does not choose.
+                auto res = [&]() -> Value {
+                    if constexpr (short_on_true) {
+                        auto one = iN(rewriter, op.getLoc(), lhs.getType(), 1);
+                        return rewriter.create< LLVM::SelectOp >(op.getLoc(), lhs, one, rhs);
+                    } else {
+                        auto zero = iN(rewriter, op.getLoc(), lhs.getType(), 0);
+                        return rewriter.create< LLVM::SelectOp >(op.getLoc(), lhs, rhs, zero);
+                    }
+                }();
+
+                rewriter.replaceOpWithNewOp< LLVM::ZExtOp >(op, op.getResult().getType(), res);
+                return logical_result::success();
+            }
+
             logical_result matchAndRewrite(
                 LOp op, adaptor_t ops, conversion_rewriter &rewriter) const override
             {
+                // The left hand side is evaluated in both cases.
+                auto lhs = mlir::dyn_cast< core::LazyOp >(ops.getLhs().getDefiningOp());
+                if (lhs && lhs.getLazy().hasOneBlock()
+                    && this->cost_model.is_cheap(ops.getRhs().getDefiningOp()))
+                {
+                    return speculate(op, ops, rewriter);
+                }
+
                 /* Splitting the block at the place of the logical operation.
                  * It is divided into 3 parts:
                  *   1) the operations that happen before the logical operation, to this
@@ -127,9 +250,88 @@ namespace vast
             }
         };
 
+        struct lazy_select : lazy_base< core::SelectOp >
+        {
+            using op_t = core::SelectOp;
+            using base = lazy_base< op_t >;
+            using base::base;
+            using adaptor_t = typename op_t::Adaptor;
+
+            static bool yields_value(op_t op)
+            {
+                return op.getNumResults() == 1
+                    && !mlir::isa< LLVM::LLVMVoidType, mlir::NoneType >(op.getResult(0).getType());
+            }
+
+            void replace(op_t op, Value res, conversion_rewriter &rewriter) const
+            {
+                if (yields_value(op))
+                    rewriter.replaceOp(op, res);
+                else
+                    rewriter.eraseOp(op);
+            }
+
+            logical_result matchAndRewrite(
+                op_t op, adaptor_t ops, conversion_rewriter &rewriter) const override
+            {
+                auto then_lazy = ops.getThenRegion().getDefiningOp();
+                auto else_lazy = ops.getElseRegion().getDefiningOp();
+
+                if (yields_value(op)
+                    && this->cost_model.is_cheap(then_lazy)
+                    && this->cost_model.is_cheap(else_lazy))
+                {
+                    auto then_res = this->lazy_inline(then_lazy, op, rewriter);
+                    auto else_res = this->lazy_inline(else_lazy, op, rewriter);
+                    auto cond     = this->to_i1(rewriter, op.getLoc(), ops.getCond());
+
+                    rewriter.replaceOpWithNewOp< LLVM::SelectOp >(op, cond, then_res, else_res);
+                    return logical_result::success();
+                }
+
+                // Same as for logical operations, the block is split into the
+                // part that evaluates the condition, blocks for both sides and the
+                // end block that receives the selected value.
+                auto curr_block = rewriter.getBlock();
+                auto then_block = curr_block->splitBlock(op);
+                auto else_block = then_block->splitBlock(op);
+                auto end_block  = else_block->splitBlock(op);
+
+                auto then_res = this->lazy_into_block(then_lazy, then_block, rewriter);
+                auto else_res = this->lazy_into_block(else_lazy, else_block, rewriter);
+
+                auto branch_to_end = [&](Block *last, Value res) {
+                    rewriter.setInsertionPointToEnd(last);
+                    if (res)
+                        rewriter.create< LLVM::BrOp >(op.getLoc(), res, end_block);
+                    else
+                        rewriter.create< LLVM::BrOp >(op.getLoc(), mlir::ValueRange(), end_block);
+                };
+
+                branch_to_end(&*std::prev(else_block->getIterator()), yields_value(op) ? then_res : Value());
+                branch_to_end(&*std::prev(end_block->getIterator()), yields_value(op) ? else_res : Value());
+
+                rewriter.setInsertionPointToEnd(curr_block);
+                auto cond = this->to_i1(rewriter, op.getLoc(), ops.getCond());
+                rewriter.create< LLVM::CondBrOp >(
+                    op.getLoc(), cond, then_block, mlir::ValueRange(), else_block, mlir::ValueRange(),
+                    this->cond_branch_weights(op)
+                );
+
+                Value end_arg;
+                if (yields_value(op))
+                    end_arg = end_block->addArgument(op.getResult(0).getType(), op.getLoc());
+
+                rewriter.setInsertionPointToStart(end_block);
+                replace(op, end_arg, rewriter);
+                return logical_result::success();
+            }
+        };
+
         using bin_lop_conversions = util::type_list<
             lazy_bin_logical< core::BinLAndOp, false >,
-            lazy_bin_logical< core::BinLOrOp, true >
+            lazy_bin_logical< core::BinLOrOp, true >,
+            lazy_select
         >;
 
     } //namespace pattern
@@ -148,8 +350,20 @@ namespace vast
             return target;
         }
 
-        static void populate_conversions(config_t &config) {
-            populate_conversions_base< pattern::bin_lop_conversions >(config);
+        // Lazy patterns are parametrized by the speculation threshold, hence
+        // cannot be added by the generic `populate_conversions_base`.
+        template< typename list >
+        void populate_lazy_conversions(config_t &config) {
+            if constexpr ( !list::empty ) {
+                using pattern = typename list::head;
+                config.patterns.template add< pattern >(config.getContext(), lazy_cost_threshold);
+                base::template legalize< pattern >(config);
+                populate_lazy_conversions< typename list::tail >(config);
+            }
+        }
+
+        void populate_conversions(config_t &config) {
+            populate_lazy_conversions< pattern::bin_lop_conversions >(config);
         }
     };
 
@@ -107,6 +107,10 @@ namespace vast
                     then_region.getType(), yielded_val,
                     then_region, else_region);
 
+            auto weights_name = core::CoreDialect::getBranchWeightsAttrName();
+            if (auto weights = op->getAttr(weights_name))
+                select->setAttr(weights_name, weights);
+
             rewriter.eraseOp(yield.op());
             rewriter.replaceOp(op, select.getResults());
             return mlir::success();
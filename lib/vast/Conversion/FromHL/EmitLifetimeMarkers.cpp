@@ -0,0 +1,157 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#include "vast/Conversion/Passes.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/IR/Builders.h>
+#include <mlir/IR/Dominance.h>
+#include <mlir/Interfaces/FunctionInterfaces.h>
+VAST_UNRELAX_WARNINGS
+
+#include "PassesDetails.hpp"
+
+#include "vast/Dialect/Core/CoreTraits.hpp"
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Dialect/LowLevel/LowLevelOps.hpp"
+
+#include "vast/Util/Common.hpp"
+
+namespace vast::conv::lifetimes
+{
+    namespace
+    {
+        // `ll.scope_ret` and `ll.scope_recurse` leave the innermost `ll.scope`,
+        // inline scopes forward them further up.
+        operation left_scope( operation op )
+        {
+            return op->getParentOfType< ll::Scope >();
+        }
+
+        // Returns true if `op` transfers control out of `scope`.
+        bool leaves( operation op, mlir::Region &scope )
+        {
+            if ( core::is_return( op ) )
+                return true;
+
+            if ( mlir::isa< ll::ScopeRet, ll::ScopeRecurse >( op ) ) {
+                auto left = left_scope( op );
+                return !left || !scope.isAncestor( left->getParentRegion() );
+            }
+
+            // A conditional scope return also continues within the scope,
+            // the variable conservatively stays live on that path.
+            if ( op->getParentRegion() != &scope || op->getNumSuccessors() != 0 )
+                return false;
+
+            // Yields and other terminators of the scope region itself fall
+            // through to the parent operation.
+            return op->hasTrait< mlir::OpTrait::IsTerminator >()
+                && op == &op->getBlock()->back();
+        }
+
+        struct lifetime_emitter
+        {
+            mlir::FunctionOpInterface fn;
+            mlir::DominanceInfo dom;
+
+            explicit lifetime_emitter( mlir::FunctionOpInterface fn ) : fn( fn ), dom( fn ) {}
+
+            bool dominates_uses( operation start, ll::UninitializedVar var )
+            {
+                return llvm::all_of( var->getUsers(), [&]( operation user ) {
+                    return user == start || dom.properlyDominates( start, user );
+                } );
+            }
+
+            // Emits markers for a variable declared in a nested scope and
+            // returns false if the variable has to keep function lifetime.
+            bool emit( ll::UninitializedVar var, mlir::OpBuilder &bld )
+            {
+                auto &scope = *var->getParentRegion();
+                auto loc    = var.getLoc();
+
+                bld.setInsertionPointAfter( var );
+                auto start = bld.create< ll::LifetimeStart >( loc, var.getResult() );
+
+                // Code that reaches a use bypassing the declaration (e.g. jumps
+                // into the middle of a `switch`) would access dead storage.
+                if ( !dominates_uses( start, var ) ) {
+                    start->erase();
+                    return false;
+                }
+
+                llvm::SmallVector< operation > exits;
+                scope.walk( [&]( operation op ) {
+                    if ( leaves( op, scope ) && dom.properlyDominates( start, op ) )
+                        exits.push_back( op );
+                } );
+
+                for ( auto exit : exits ) {
+                    bld.setInsertionPoint( exit );
+                    bld.create< ll::LifetimeEnd >( loc, var.getResult() );
+                }
+
+                // Blocks of regions without terminators fall through at their end.
+                for ( auto &block : scope ) {
+                    if ( block.empty() || block.mightHaveTerminator() )
+                        continue;
+                    if ( start->getBlock() != &block && !dom.properlyDominates( start, &block.back() ) )
+                        continue;
+                    bld.setInsertionPointToEnd( &block );
+                    bld.create< ll::LifetimeEnd >( loc, var.getResult() );
+                }
+
+                return true;
+            }
+
+            void run()
+            {
+                auto &body = fn.getFunctionBody();
+                if ( body.empty() )
+                    return;
+
+                // Jumps to labels are not explicit in the control flow yet.
+                bool has_gotos = false;
+                fn->walk( [&]( hl::GotoStmt ) { has_gotos = true; } );
+                if ( has_gotos )
+                    return;
+
+                llvm::SmallVector< ll::UninitializedVar > scoped;
+                fn->walk( [&]( ll::UninitializedVar var ) {
+                    if ( var->getParentRegion() != &body )
+                        scoped.push_back( var );
+                } );
+
+                if ( scoped.empty() )
+                    return;
+
+                // Allocations are hoisted to the entry block in declaration
+                // order, so that the backend sees them as static and can color
+                // their slots.
+                mlir::OpBuilder bld( fn.getContext() );
+                auto anchor = &body.front().front();
+                for ( auto var : scoped ) {
+                    if ( emit( var, bld ) )
+                        var->moveBefore( anchor );
+                }
+            }
+        };
+
+    } // namespace
+
+    struct EmitLifetimeMarkers : EmitLifetimeMarkersBase< EmitLifetimeMarkers >
+    {
+        void runOnOperation() override
+        {
+            getOperation()->walk( [&]( mlir::FunctionOpInterface fn ) {
+                lifetime_emitter( fn ).run();
+            } );
+        }
+    };
+
+} // namespace vast::conv::lifetimes
+
+std::unique_ptr< mlir::Pass > vast::createEmitLifetimeMarkersPass()
+{
+    return std::make_unique< vast::conv::lifetimes::EmitLifetimeMarkers >();
+}
@@ -24,6 +24,7 @@ VAST_UNRELAX_WARNINGS
 #include "vast/Conversion/Common/Rewriter.hpp"
 
 
+#include "vast/Dialect/Core/CoreOps.hpp"
 #include "vast/Dialect/Core/CoreTraits.hpp"
 #include "vast/Dialect/HighLevel/HighLevelDialect.hpp"
 #include "vast/Dialect/LowLevel/LowLevelOps.hpp"
@@ -124,6 +125,9 @@ namespace vast::conv
             //        - `nullptr` means the next block after scope is used.
             mlir::Block *entry;
             mlir::Block *exit;
+            // `break` inside of a nested `hl.switch` belongs to the switch, while
+            // `continue` still belongs to us.
+            bool in_switch = false;
 
             handle_terminators( bld_t &bld, mlir::Block *entry, mlir::Block *exit )
                 : bld( bld ), entry( entry ), exit( exit )
@@ -154,6 +158,16 @@ namespace vast::conv
                 if ( starts_cf_scope( op ) )
                     return mlir::success();
 
+                if ( mlir::isa< hl::SwitchOp >( op ) && !in_switch )
+                {
+                    auto nested = *this;
+                    nested.in_switch = true;
+                    for ( auto &region : op->getRegions() )
+                        if ( mlir::failed( nested.run( region ) ) )
+                            return mlir::failure();
+                    return mlir::success();
+                }
+
                 for ( auto &region : op->getRegions() )
                     if ( mlir::failed( run( region ) ) )
                         return mlir::failure();
@@ -186,6 +200,9 @@ namespace vast::conv
 
             maybe_op_t do_replace( hl::BreakOp op )
             {
+                if ( in_switch )
+                    return {};
+
                 auto g = mlir::OpBuilder::InsertionGuard( bld );
                 bld.setInsertionPointAfter( op );
                 if ( exit )
@@ -214,6 +231,46 @@ namespace vast::conv
 
         };
 
+        // Replaces `hl.break` that belongs to a switch with a branch to `exit`.
+        // `continue` and `return` are left to the enclosing loop and to
+        // the generic patterns.
+        template< typename bld_t >
+        struct handle_switch_breaks
+        {
+            bld_t &bld;
+            mlir::Block *exit;
+
+            handle_switch_breaks( bld_t &bld, mlir::Block *exit )
+                : bld( bld ), exit( exit )
+            {}
+
+            void run( mlir::Region &region )
+            {
+                for ( auto &block : region )
+                    for ( auto &op : block )
+                        run( &op );
+            }
+
+            void run( mlir::Operation *op )
+            {
+                if ( auto br = mlir::dyn_cast< hl::BreakOp >( op ) )
+                {
+                    auto g = mlir::OpBuilder::InsertionGuard( bld );
+                    bld.setInsertionPointAfter( br );
+                    bld.template create< ll::Br >( br.getLoc(), exit );
+                    bld.eraseOp( br );
+                    return;
+                }
+
+                // Nested loops and switches own their `break`.
+                if ( mlir::isa< hl::ForOp, hl::WhileOp, hl::DoOp, hl::SwitchOp >( op ) )
+                    return;
+
+                for ( auto &region : op->getRegions() )
+                    run( region );
+            }
+        };
+
         template< typename op_t >
         struct base_pattern : OpConversionPattern< op_t >
         {
@@ -241,6 +298,15 @@ namespace vast::conv
 
                 return std::make_tuple( cond_yield, value );
             }
+
+            // Branch weights attached by profile use are kept on the lowered
+            // branch, they are ordered the same way as its successors.
+            static void copy_branch_weights( mlir::Operation *from, mlir::Operation *to )
+            {
+                auto name = core::CoreDialect::getBranchWeightsAttrName();
+                if ( auto weights = from->getAttr( name ) )
+                    to->setAttr( name, weights );
+            }
         };
 
         struct if_op : base_pattern< hl::IfOp >
@@ -273,9 +339,10 @@ namespace vast::conv
                 auto true_block = inline_region_before( rewriter,
                                                         op.getThenRegion(), tail_block );
 
-                bld.make_at_end< ll::CondBr >( cond_block,
-                                               op.getLoc(), cond_value,
-                                               true_block, false_block );
+                auto br = bld.make_at_end< ll::CondBr >( cond_block,
+                                                         op.getLoc(), cond_value,
+                                                         true_block, false_block );
+                copy_branch_weights( op, br );
                 rewriter.eraseOp( cond_yield_op );
 
 
@@ -350,8 +417,9 @@ namespace vast::conv
                 auto [ cond_yield, value ] = fetch_cond_yield( bld, *cond_block );
                 VAST_CHECK( value, "Condition region yield unexpected type" );
 
-                bld.make_at_end< ll::CondScopeRet >( cond_block,
-                                                     op.getLoc(), *value, body_block );
+                auto ret = bld.make_at_end< ll::CondScopeRet >( cond_block,
+                                                                op.getLoc(), *value, body_block );
+                copy_branch_weights( op, ret );
                 rewriter.eraseOp( cond_yield );
 
                 VAST_PATTERN_CHECK(parent_t::tie( bld, op.getLoc(),
@@ -404,8 +472,9 @@ namespace vast::conv
                 auto [ cond_yield, value ] = fetch_cond_yield( bld, *cond_block );
                 VAST_PATTERN_CHECK( value, "Condition region yield unexpected type" );
 
-                bld.make_at_end< ll::CondScopeRet >( cond_block,
-                                                     op.getLoc(), *value, body_block );
+                auto ret = bld.make_at_end< ll::CondScopeRet >( cond_block,
+                                                                op.getLoc(), *value, body_block );
+                copy_branch_weights( op, ret );
                 rewriter.eraseOp( cond_yield );
 
                 auto mk_tie = [ & ]( auto &from, auto &to )
@@ -428,6 +497,260 @@ namespace vast::conv
             }
         };
 
+        // Flattens the body of `hl.switch` into a chain of blocks, one per label,
+        // that fall through into each other and dispatches between them with
+        // a single `ll.switch`. This keeps case values dense so the backend can
+        // form jump tables.
+        //
+        // ```
+        // ^head:
+        //   cond ops
+        //   ll.switch %cond : iN, ^default [^case_0, ^case_1]
+        // ^case_0:
+        //   ...
+        //   ll.br ^case_1 // fallthrough
+        // ^case_1:
+        //   ...
+        //   ll.br ^tail   // break
+        // ^default:
+        //   ...
+        // ^tail:
+        // ```
+        struct switch_op : base_pattern< hl::SwitchOp >
+        {
+            using op_t = hl::SwitchOp;
+            using parent_t = base_pattern< op_t >;
+            using parent_t::parent_t;
+
+            using expanded_t = llvm::SmallPtrSet< mlir::Operation *, 8 >;
+
+            // Case values have to be known at compile time, we accept constants
+            // possibly hidden behind implicit integral casts.
+            static std::optional< llvm::APSInt > case_value( hl::CaseOp op )
+            {
+                auto &lhs = op.getLhs();
+                if ( lhs.empty() || !terminator_t< hl::ValueYieldOp >::has( lhs.front() ) )
+                    return std::nullopt;
+
+                auto value = terminator_t< hl::ValueYieldOp >::get( lhs.front() )
+                    .op().getResult();
+                while ( auto cast = value.getDefiningOp< hl::ImplicitCastOp >() )
+                    value = cast.getValue();
+
+                auto cst = value.getDefiningOp< hl::ConstantOp >();
+                if ( !cst )
+                    return std::nullopt;
+
+                auto attr = mlir::dyn_cast< core::IntegerAttr >( cst.getValue() );
+                if ( !attr )
+                    return std::nullopt;
+                return attr.getValue();
+            }
+
+            // Labels are flattened only if they are nested in other labels or
+            // scopes, jumping into the middle of other control flow (Duff's device)
+            // is not supported.
+            static bool is_flattenable( hl::SwitchOp op, mlir::Operation *label )
+            {
+                for ( auto parent = label->getParentOp(); parent != op;
+                      parent = parent->getParentOp() )
+                {
+                    if ( !mlir::isa< core::ScopeOp, hl::CaseOp, hl::DefaultOp >( parent ) )
+                        return false;
+                }
+
+                if ( auto case_op = mlir::dyn_cast< hl::CaseOp >( label ) )
+                    return case_value( case_op ).has_value();
+                return true;
+            }
+
+            static bool is_lowerable( hl::SwitchOp op )
+            {
+                if ( op.getCases().size() != 1 || op.getCondRegion().empty() )
+                    return false;
+
+                auto &cond = op.getCondRegion().front();
+                if ( !terminator_t< hl::ValueYieldOp >::has( cond ) )
+                    return false;
+
+                auto yield = terminator_t< hl::ValueYieldOp >::get( cond ).op();
+                if ( !mlir::isa< mlir::IntegerType >( yield.getResult().getType() ) )
+                    return false;
+
+                bool lowerable = true;
+                op->walk( [ & ]( mlir::Operation *nested ) {
+                    if ( !mlir::isa< hl::CaseOp, hl::DefaultOp >( nested ) )
+                        return;
+                    if ( nested->getParentOfType< hl::SwitchOp >() != op )
+                        return;
+                    lowerable &= is_flattenable( op, nested );
+                } );
+
+                return lowerable;
+            }
+
+            static core::ScopeOp sole_scope( mlir::Region &body )
+            {
+                if ( !body.hasOneBlock() || size( body.front() ) != 1 )
+                    return {};
+                return mlir::dyn_cast< core::ScopeOp >( body.front().front() );
+            }
+
+            static mlir::Operation *next_label( mlir::Block &block, const expanded_t &expanded )
+            {
+                for ( auto &op : block )
+                {
+                    if ( expanded.contains( &op ) )
+                        continue;
+                    if ( mlir::isa< hl::CaseOp, hl::DefaultOp >( op ) )
+                        return &op;
+                    if ( auto scope = mlir::dyn_cast< core::ScopeOp >( op ) )
+                        if ( scope.getBody().hasOneBlock() )
+                            return &op;
+                }
+                return nullptr;
+            }
+
+            static bool is_terminated( mlir::Block &block, const expanded_t &expanded )
+            {
+                for ( auto &op : llvm::reverse( block ) )
+                {
+                    if ( expanded.contains( &op ) )
+                        continue;
+                    return any_terminator_t::is( &op );
+                }
+                return false;
+            }
+
+            mlir::LogicalResult matchAndRewrite(
+                op_t op,
+                typename op_t::Adaptor ops,
+                conversion_rewriter &rewriter) const override
+            {
+                auto bld = rewriter_wrapper_t( rewriter );
+
+                auto [ original_block, tail_block ] = split_at_op( op, rewriter );
+                VAST_CHECK( original_block && tail_block,
+                            "Failed extraction of switchop into block." );
+
+                // Weights of cases are ordered as the cases in the body, they
+                // have to follow the destinations once labels are flattened.
+                auto weights = op->getAttrOfType< mlir::DenseI32ArrayAttr >(
+                    core::CoreDialect::getBranchWeightsAttrName()
+                );
+                llvm::DenseMap< mlir::Operation *, std::int32_t > case_weights;
+                if ( weights )
+                {
+                    auto next = std::next( weights.asArrayRef().begin() );
+                    op->walk< mlir::WalkOrder::PreOrder >( [ & ]( hl::CaseOp case_op ) {
+                        if ( case_op->getParentOfType< hl::SwitchOp >() != op )
+                            return;
+                        if ( next != weights.asArrayRef().end() )
+                            case_weights[ case_op ] = *next++;
+                    } );
+                }
+
+                handle_switch_breaks( rewriter, tail_block ).run( op.getCases().front() );
+
+                auto cond_block = inline_region_before( rewriter,
+                                                        op.getCondRegion(), tail_block );
+                auto cond_yield = terminator_t< hl::ValueYieldOp >::get( *cond_block ).op();
+                auto cond = cond_yield.getResult();
+                auto bitwidth = cond.getType().getIntOrFloatBitWidth();
+
+                // Body of the switch is usually a compound statement, its scope
+                // has no meaning once labels are flattened.
+                auto body = &op.getCases().front();
+                if ( auto scope = sole_scope( *body ) )
+                    body = &scope.getBody();
+
+                std::vector< mlir::Block * > segments;
+                if ( !body->empty() )
+                    segments.push_back( inline_region_before( rewriter, *body, tail_block ) );
+
+                llvm::SmallVector< llvm::APInt > values;
+                llvm::SmallVector< mlir::Block * > dests;
+                llvm::SmallVector< std::int32_t > dest_weights;
+                mlir::Block *default_dest = tail_block;
+
+                expanded_t expanded;
+                for ( std::size_t i = 0; i < segments.size(); ++i )
+                {
+                    while ( auto label = next_label( *segments[ i ], expanded ) )
+                    {
+                        expanded.insert( label );
+
+                        if ( auto scope = mlir::dyn_cast< core::ScopeOp >( label ) )
+                        {
+                            rewriter.inlineBlockBefore( &scope.getBody().front(), scope );
+                            rewriter.eraseOp( scope );
+                            continue;
+                        }
+
+                        auto dest = rewriter.splitBlock( segments[ i ],
+                                                         mlir::Block::iterator( label ) );
+                        segments.push_back( dest );
+
+                        auto label_body = [ & ] () -> mlir::Region & {
+                            if ( auto case_op = mlir::dyn_cast< hl::CaseOp >( label ) )
+                            {
+                                auto value = case_value( case_op );
+                                VAST_PATTERN_CHECK( value, "Case value is not a constant." );
+                                values.push_back( value->extOrTrunc( bitwidth ) );
+                                dests.push_back( dest );
+                                dest_weights.push_back( case_weights.lookup( case_op ) );
+                                return case_op.getBody();
+                            }
+
+                            default_dest = dest;
+                            return mlir::cast< hl::DefaultOp >( label ).getBody();
+                        }();
+
+                        if ( !label_body.empty() )
+                            rewriter.inlineBlockBefore( &label_body.front(), label );
+                        rewriter.eraseOp( label );
+                    }
+                }
+
+                // Labels fall through into the next one, the last one leaves the switch.
+                for ( std::size_t i = 0; i < segments.size(); ++i )
+                {
+                    auto next = i + 1 < segments.size() ? segments[ i + 1 ] : tail_block;
+                    if ( !is_terminated( *segments[ i ], expanded ) )
+                        bld.make_at_end< ll::Br >( segments[ i ], op.getLoc(), next );
+                }
+
+                auto dispatch = bld.make_at_end< ll::Switch >( cond_block, op.getLoc(),
+                                                               cond, default_dest, values, dests );
+                if ( weights && case_weights.size() == dests.size() )
+                {
+                    dest_weights.insert( dest_weights.begin(), weights.asArrayRef().front() );
+                    dispatch->setAttr( core::CoreDialect::getBranchWeightsAttrName(),
+                                       rewriter.getDenseI32ArrayAttr( dest_weights ) );
+                }
+                rewriter.eraseOp( cond_yield );
+                rewriter.mergeBlocks( cond_block, original_block, std::nullopt );
+
+                // Same as for `hl.if`, we may end up with an empty tail block.
+                if ( !any_terminator_t::has( *tail_block ) )
+                {
+                    bld.guarded_at_end( tail_block, [&](){
+                        bld->template create< ll::ScopeRet >( op.getLoc() );
+                    });
+                }
+                rewriter.eraseOp( op );
+
+                return mlir::success();
+            }
+
+            static void legalize( conversion_target &trg )
+            {
+                trg.addDynamicallyLegalOp< hl::SwitchOp >( [] ( hl::SwitchOp op ) {
+                    return !is_lowerable( op );
+                } );
+            }
+        };
+
         template< typename op_t, typename trg_t >
         struct replace : base_pattern< op_t >
         {
@@ -456,6 +779,7 @@ namespace vast::conv
               if_op
             , while_op
             , for_op
+            , switch_op
             , replace< hl::ReturnOp, ll::ReturnOp >
         >;
 
@@ -0,0 +1,403 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#include "vast/Conversion/Passes.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/SCF/IR/SCF.h>
+#include <mlir/IR/IRMapping.h>
+#include <mlir/IR/PatternMatch.h>
+
+#include <llvm/ADT/TypeSwitch.h>
+VAST_UNRELAX_WARNINGS
+
+#include "PassesDetails.hpp"
+
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+
+#include "vast/Util/Common.hpp"
+
+namespace vast::conv::hltoscf
+{
+    namespace
+    {
+        template< typename ... Args >
+        bool is_one_of( operation op ) { return ( mlir::isa< Args >( op ) || ... ); }
+
+        bool is_loop( operation op ) { return is_one_of< hl::ForOp, hl::WhileOp, hl::DoOp >( op ); }
+
+        // Returns the statement that `break` (or `continue` if `with_switch` is
+        // false) transfers control out of.
+        operation jump_target( operation op, bool with_switch )
+        {
+            for ( auto parent = op->getParentOp(); parent; parent = parent->getParentOp() ) {
+                if ( is_loop( parent ) || ( with_switch && mlir::isa< hl::SwitchOp >( parent ) ) )
+                    return parent;
+            }
+            return nullptr;
+        }
+
+        // Single block `scf` regions can only be left by falling through to the
+        // next iteration, therefore any other exit out of `loop` prevents raising.
+        bool has_structured_exits( operation loop )
+        {
+            auto result = loop->walk( [&]( operation op ) {
+                if ( is_one_of< hl::ReturnOp, hl::GotoStmt, hl::LabelStmt >( op ) )
+                    return mlir::WalkResult::interrupt();
+                if ( mlir::isa< hl::BreakOp >( op ) && jump_target( op, true ) == loop )
+                    return mlir::WalkResult::interrupt();
+                if ( mlir::isa< hl::ContinueOp >( op ) && jump_target( op, false ) == loop )
+                    return mlir::WalkResult::interrupt();
+                return mlir::WalkResult::advance();
+            } );
+            return !result.wasInterrupted();
+        }
+
+        bool is_load( operation op )
+        {
+            auto cast = mlir::dyn_cast_or_null< hl::ImplicitCastOp >( op );
+            return cast && cast.getKind() == hl::CastKind::LValueToRValue;
+        }
+
+        // Declaration is only ever read after its initialization, and its address
+        // is not taken, therefore its value cannot change between reads.
+        bool is_read_only( mlir_value decl )
+        {
+            for ( auto user : decl.getUsers() ) {
+                auto ref = mlir::dyn_cast< hl::DeclRefOp >( user );
+                if ( !ref )
+                    return false;
+                for ( auto ref_user : ref->getUsers() ) {
+                    if ( !is_load( ref_user ) )
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        // Everything in the region is either a load, constant or comparison,
+        // so evaluating it has no side effects.
+        bool is_pure_condition( region_t &region )
+        {
+            if ( !region.hasOneBlock() )
+                return false;
+            for ( auto &op : region.front() ) {
+                if ( !is_one_of< hl::DeclRefOp, hl::ImplicitCastOp, hl::ConstantOp,
+                                 hl::CmpOp, hl::CondYieldOp >( &op ) )
+                    return false;
+                if ( auto cast = mlir::dyn_cast< hl::ImplicitCastOp >( op ) ) {
+                    if ( cast.getKind() != hl::CastKind::LValueToRValue )
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        hl::CondYieldOp cond_yield( region_t &region )
+        {
+            if ( region.empty() || region.front().empty() )
+                return {};
+            return mlir::dyn_cast< hl::CondYieldOp >( region.front().back() );
+        }
+
+        // `for (T i = lb; i < ub; i += step)` where `i` is a signed integer
+        // variable not visible outside of the loop and not written in its body
+        // and `ub` is loop invariant.
+        struct canonical_for
+        {
+            hl::VarDeclOp iv;
+            mlir_value bound;
+            std::int64_t step;
+
+            static std::optional< canonical_for > match( hl::ForOp op )
+            {
+                if ( !is_pure_condition( op.getCondRegion() ) )
+                    return std::nullopt;
+
+                auto yield = cond_yield( op.getCondRegion() );
+                auto cmp = yield ? yield.getResult().getDefiningOp< hl::CmpOp >() : hl::CmpOp();
+                if ( !cmp || cmp.getPredicate() != hl::Predicate::slt )
+                    return std::nullopt;
+
+                auto lhs = cmp.getLhs().getDefiningOp< hl::ImplicitCastOp >();
+                if ( !is_load( lhs ) )
+                    return std::nullopt;
+                auto ref = lhs.getValue().getDefiningOp< hl::DeclRefOp >();
+                auto iv  = ref ? ref.getDecl().getDefiningOp< hl::VarDeclOp >() : hl::VarDeclOp();
+                if ( !iv || !is_induction_variable( op, iv ) )
+                    return std::nullopt;
+
+                auto type = cmp.getLhs().getType().dyn_cast< mlir::IntegerType >();
+                if ( !type || !type.isSigned() || cmp.getRhs().getType() != type )
+                    return std::nullopt;
+
+                auto bound = invariant_bound( op, cmp.getRhs() );
+                if ( !bound )
+                    return std::nullopt;
+
+                auto step = induction_step( op, iv );
+                if ( !step )
+                    return std::nullopt;
+
+                return canonical_for{ iv, bound, *step };
+            }
+
+            static bool is_induction_variable( hl::ForOp op, hl::VarDeclOp iv )
+            {
+                auto is_body_use = [&] ( operation user ) {
+                    return op.getBodyRegion().isAncestor( user->getParentRegion() );
+                };
+
+                for ( auto user : iv->getUsers() ) {
+                    if ( !op->isProperAncestor( user ) )
+                        return false;
+                    if ( !is_body_use( user ) )
+                        continue;
+                    for ( auto ref_user : user->getUsers() ) {
+                        if ( !is_load( ref_user ) )
+                            return false;
+                    }
+                }
+                return true;
+            }
+
+            // Values computed before the loop (e.g. promoted variables) are
+            // invariant as well.
+            static mlir_value invariant_bound( hl::ForOp op, mlir_value bound )
+            {
+                auto def = bound.getDefiningOp();
+                if ( !op->isAncestor( bound.getParentRegion()->getParentOp() ) )
+                    return bound;
+                if ( mlir::isa_and_nonnull< hl::ConstantOp >( def ) )
+                    return bound;
+                if ( !is_load( def ) )
+                    return {};
+                auto ref = mlir::cast< hl::ImplicitCastOp >( def )
+                    .getValue().getDefiningOp< hl::DeclRefOp >();
+                return ref && is_read_only( ref.getDecl() ) ? bound : mlir_value();
+            }
+
+            static std::optional< std::int64_t > induction_step( hl::ForOp op, hl::VarDeclOp iv )
+            {
+                auto &incr = op.getIncrRegion();
+                if ( !incr.hasOneBlock() )
+                    return std::nullopt;
+
+                std::optional< std::int64_t > step;
+                for ( auto &inner : incr.front() ) {
+                    if ( is_one_of< hl::DeclRefOp, hl::ConstantOp >( &inner ) )
+                        continue;
+                    if ( step )
+                        return std::nullopt;
+
+                    if ( is_one_of< hl::PreIncOp, hl::PostIncOp >( &inner ) ) {
+                        auto ref = inner.getOperand( 0 ).getDefiningOp< hl::DeclRefOp >();
+                        if ( !ref || ref.getDecl() != iv )
+                            return std::nullopt;
+                        step = 1;
+                    } else if ( auto add = mlir::dyn_cast< hl::AddIAssignOp >( inner ) ) {
+                        auto ref = add.getDst().getDefiningOp< hl::DeclRefOp >();
+                        auto cst = add.getSrc().getDefiningOp< hl::ConstantOp >();
+                        if ( !ref || ref.getDecl() != iv || !cst )
+                            return std::nullopt;
+                        auto attr = mlir::dyn_cast< core::IntegerAttr >( cst.getValue() );
+                        if ( !attr || !attr.getValue().isStrictlyPositive() )
+                            return std::nullopt;
+                        step = attr.getValue().getExtValue();
+                    } else {
+                        return std::nullopt;
+                    }
+                }
+                return step;
+            }
+        };
+
+        struct loop_raiser
+        {
+            mlir::IRRewriter &rewriter;
+
+            mlir_value coerce_condition( hl::CondYieldOp yield )
+            {
+                auto cond = yield.getResult();
+                auto i1 = rewriter.getI1Type();
+                if ( cond.getType() == i1 )
+                    return cond;
+                return rewriter.create< hl::ImplicitCastOp >(
+                    yield.getLoc(), i1, cond, hl::CastKind::IntegralToBoolean
+                );
+            }
+
+            // Moves content of the `hl` condition region to the end of `block`
+            // and terminates it by `scf.condition`.
+            void inline_condition( region_t &cond, block_ptr block )
+            {
+                auto yield = cond_yield( cond );
+                rewriter.mergeBlocks( &cond.front(), block );
+                rewriter.setInsertionPoint( yield );
+                rewriter.create< mlir::scf::ConditionOp >(
+                    yield.getLoc(), coerce_condition( yield ), mlir::ValueRange()
+                );
+                rewriter.eraseOp( yield );
+            }
+
+            void inline_body( region_t &body, block_ptr block )
+            {
+                if ( !body.empty() )
+                    rewriter.mergeBlocks( &body.front(), block );
+            }
+
+            void yield( block_ptr block, loc_t loc )
+            {
+                rewriter.setInsertionPointToEnd( block );
+                rewriter.create< mlir::scf::YieldOp >( loc );
+            }
+
+            // Creates `scf.while` without loop-carried values, returns its
+            // `before` and `after` blocks.
+            std::pair< block_ptr, block_ptr > make_while( operation op )
+            {
+                rewriter.setInsertionPoint( op );
+                auto loop = rewriter.create< mlir::scf::WhileOp >(
+                    op->getLoc(), mlir::TypeRange(), mlir::ValueRange()
+                );
+                auto before = rewriter.createBlock( &loop.getBefore() );
+                auto after  = rewriter.createBlock( &loop.getAfter() );
+                return { before, after };
+            }
+
+            bool has_condition( region_t &cond ) { return bool( cond_yield( cond ) ); }
+
+            logical_result raise( hl::WhileOp op )
+            {
+                if ( !has_condition( op.getCondRegion() ) )
+                    return mlir::failure();
+
+                auto [before, after] = make_while( op );
+                inline_condition( op.getCondRegion(), before );
+                inline_body( op.getBodyRegion(), after );
+                yield( after, op.getLoc() );
+                rewriter.eraseOp( op );
+                return mlir::success();
+            }
+
+            logical_result raise( hl::DoOp op )
+            {
+                if ( !has_condition( op.getCondRegion() ) )
+                    return mlir::failure();
+
+                auto [before, after] = make_while( op );
+                inline_body( op.getBodyRegion(), before );
+                inline_condition( op.getCondRegion(), before );
+                yield( after, op.getLoc() );
+                rewriter.eraseOp( op );
+                return mlir::success();
+            }
+
+            logical_result raise( hl::ForOp op )
+            {
+                if ( !has_condition( op.getCondRegion() ) )
+                    return mlir::failure();
+
+                if ( auto canonical = canonical_for::match( op ) )
+                    return raise_to_for( op, *canonical );
+
+                auto [before, after] = make_while( op );
+                inline_condition( op.getCondRegion(), before );
+                inline_body( op.getBodyRegion(), after );
+                inline_body( op.getIncrRegion(), after );
+                yield( after, op.getLoc() );
+                rewriter.eraseOp( op );
+                return mlir::success();
+            }
+
+            mlir_value load( hl::VarDeclOp var, loc_t loc )
+            {
+                auto ref = rewriter.create< hl::DeclRefOp >( loc, var.getType(), var );
+                auto type = var.getType().cast< hl::LValueType >().getElementType();
+                return rewriter.create< hl::ImplicitCastOp >(
+                    loc, type, ref, hl::CastKind::LValueToRValue
+                );
+            }
+
+            mlir_value cast( mlir_value value, mlir_type type )
+            {
+                return rewriter.create< hl::ImplicitCastOp >(
+                    value.getLoc(), type, value, hl::CastKind::IntegralCast
+                );
+            }
+
+            // `scf.for` works with signless integers, the induction variable keeps
+            // its original storage so that the body can be moved over unchanged,
+            // it is updated at the beginning of each iteration.
+            logical_result raise_to_for( hl::ForOp op, const canonical_for &loop )
+            {
+                auto loc  = op.getLoc();
+                auto type = loop.bound.getType().cast< mlir::IntegerType >();
+                auto signless = rewriter.getIntegerType( type.getWidth() );
+
+                rewriter.setInsertionPoint( op );
+                auto lb = cast( load( loop.iv, loc ), signless );
+
+                auto ub = [&] {
+                    auto def = loop.bound.getDefiningOp();
+                    if ( !def || !op->isAncestor( def ) )
+                        return cast( loop.bound, signless );
+
+                    mlir::IRMapping mapping;
+                    for ( auto operand : def->getOperands() ) {
+                        if ( auto ref = operand.getDefiningOp() )
+                            rewriter.clone( *ref, mapping );
+                    }
+                    return cast( rewriter.clone( *def, mapping )->getResult( 0 ), signless );
+                } ();
+
+                auto step = rewriter.create< mlir::arith::ConstantOp >(
+                    loc, rewriter.getIntegerAttr( signless, loop.step )
+                );
+
+                auto scf_for = rewriter.create< mlir::scf::ForOp >( loc, lb, ub, step );
+                auto body = scf_for.getBody();
+
+                rewriter.setInsertionPointToStart( body );
+                auto ref = rewriter.create< hl::DeclRefOp >( loc, loop.iv.getType(), loop.iv );
+                rewriter.create< hl::AssignOp >( loc, ref, cast( scf_for.getInductionVar(), type ) );
+
+                if ( !op.getBodyRegion().empty() )
+                    rewriter.inlineBlockBefore( &op.getBodyRegion().front(), body->getTerminator() );
+
+                rewriter.eraseOp( op );
+                return mlir::success();
+            }
+        };
+
+    } // namespace
+
+    struct HLToSCF : HLToSCFBase< HLToSCF >
+    {
+        void runOnOperation() override
+        {
+            // Post-order walk raises inner loops first, so outer loops see
+            // a body without `hl` loop statements where possible.
+            llvm::SmallVector< operation > loops;
+            getOperation()->walk( [&]( operation op ) {
+                if ( is_loop( op ) && has_structured_exits( op ) )
+                    loops.push_back( op );
+            } );
+
+            mlir::IRRewriter rewriter( &getContext() );
+            loop_raiser raiser{ rewriter };
+            for ( auto op : loops ) {
+                llvm::TypeSwitch< operation >( op )
+                    .Case< hl::ForOp, hl::WhileOp, hl::DoOp >( [&]( auto loop ) {
+                        (void) raiser.raise( loop );
+                    } );
+            }
+        }
+    };
+
+} // namespace vast::conv::hltoscf
+
+std::unique_ptr< mlir::Pass > vast::createHLToSCFPass()
+{
+    return std::make_unique< vast::conv::hltoscf::HLToSCF >();
+}
@@ -0,0 +1,136 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#include "vast/Conversion/Passes.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/SCF/IR/SCF.h>
+#include <mlir/Dialect/Utils/StaticValueUtils.h>
+#include <mlir/IR/IRMapping.h>
+#include <mlir/IR/PatternMatch.h>
+VAST_UNRELAX_WARNINGS
+
+#include "PassesDetails.hpp"
+
+#include "vast/Util/Common.hpp"
+
+namespace vast::conv::scfunroll
+{
+    namespace
+    {
+        // Larger bodies are not worth the code growth.
+        constexpr std::size_t max_body_size = 64;
+
+        bool is_innermost( mlir::scf::ForOp op )
+        {
+            auto result = op.getBody()->walk( []( operation inner ) {
+                if ( mlir::isa< mlir::scf::ForOp, mlir::scf::WhileOp >( inner ) )
+                    return mlir::WalkResult::interrupt();
+                return mlir::WalkResult::advance();
+            } );
+            return !result.wasInterrupted();
+        }
+
+        std::size_t body_size( mlir::scf::ForOp op )
+        {
+            std::size_t size = 0;
+            op.getBody()->walk( [&]( operation ) { ++size; } );
+            return size;
+        }
+
+        // Upstream `loopUnrollByFactor` expects `index` induction variables,
+        // loops raised from `hl` iterate over the integer type of the source.
+        struct unroller
+        {
+            mlir::IRRewriter &rewriter;
+            unsigned factor;
+
+            // Splits `for iv = lb to ub step s` at the largest `lb + k * s * factor`
+            // not greater than `ub`. The first part runs `factor` copies of the
+            // body per iteration, the original loop runs the remainder.
+            logical_result unroll( mlir::scf::ForOp op )
+            {
+                if ( !op.getInitArgs().empty() )
+                    return mlir::failure();
+
+                auto type = op.getInductionVar().getType().dyn_cast< mlir::IntegerType >();
+                auto step = mlir::getConstantIntValue( op.getStep() );
+                if ( !type || !step || *step <= 0 )
+                    return mlir::failure();
+
+                auto width = type.getWidth();
+                bool overflow = false;
+                auto stride = llvm::APInt( width, *step, true )
+                    .smul_ov( llvm::APInt( width, factor ), overflow );
+                if ( overflow )
+                    return mlir::failure();
+
+                auto loc = op.getLoc();
+                auto constant = [&]( const llvm::APInt &value ) -> mlir_value {
+                    return rewriter.create< mlir::arith::ConstantOp >(
+                        loc, rewriter.getIntegerAttr( type, value )
+                    );
+                };
+
+                // The span is computed unsigned, it does not have to fit the
+                // signed type of the induction variable.
+                rewriter.setInsertionPoint( op );
+                auto lb = op.getLowerBound();
+                auto ub = rewriter.create< mlir::arith::MaxSIOp >( loc, op.getUpperBound(), lb );
+                auto span  = rewriter.create< mlir::arith::SubIOp >( loc, ub, lb );
+                auto by    = constant( stride );
+                auto trips = rewriter.create< mlir::arith::DivUIOp >( loc, span, by );
+                auto split = rewriter.create< mlir::arith::AddIOp >(
+                    loc, lb, rewriter.create< mlir::arith::MulIOp >( loc, trips, by )
+                );
+
+                auto unrolled = rewriter.create< mlir::scf::ForOp >( loc, lb, split, by );
+                rewriter.setInsertionPoint( unrolled.getBody()->getTerminator() );
+                for ( unsigned copy = 0; copy < factor; ++copy ) {
+                    mlir_value iv = unrolled.getInductionVar();
+                    if ( copy != 0 ) {
+                        auto offset = constant( llvm::APInt( width, *step, true ) * copy );
+                        iv = rewriter.create< mlir::arith::AddIOp >( loc, iv, offset );
+                    }
+
+                    mlir::IRMapping mapping;
+                    mapping.map( op.getInductionVar(), iv );
+                    for ( auto &inner : op.getBody()->without_terminator() )
+                        rewriter.clone( inner, mapping );
+                }
+
+                rewriter.updateRootInPlace( op, [&] { op.setLowerBound( split ); } );
+                return mlir::success();
+            }
+        };
+
+    } // namespace
+
+    struct SCFUnroll : SCFUnrollBase< SCFUnroll >
+    {
+        void runOnOperation() override
+        {
+            if ( factor < 2 )
+                return;
+
+            llvm::SmallVector< mlir::scf::ForOp > loops;
+            getOperation()->walk( [&]( mlir::scf::ForOp op ) {
+                if ( is_innermost( op ) && body_size( op ) <= max_body_size )
+                    loops.push_back( op );
+            } );
+
+            mlir::IRRewriter rewriter( &getContext() );
+            unroller unroll{ rewriter, factor };
+            for ( auto op : loops ) {
+                if ( mlir::succeeded( unroll.unroll( op ) ) )
+                    ++unrolled;
+            }
+        }
+    };
+
+} // namespace vast::conv::scfunroll
+
+std::unique_ptr< mlir::Pass > vast::createSCFUnrollPass()
+{
+    return std::make_unique< vast::conv::scfunroll::SCFUnroll >();
+}
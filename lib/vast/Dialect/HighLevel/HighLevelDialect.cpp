@@ -62,7 +62,10 @@ namespace vast::hl
 
     Operation *HighLevelDialect::materializeConstant(Builder &builder, Attribute value, Type type, Location loc)
     {
-        VAST_UNIMPLEMENTED;
+        auto typed = mlir::dyn_cast< mlir::TypedAttr >(value);
+        if (!typed || typed.getType() != type)
+            return nullptr;
+        return builder.create< ConstantOp >(loc, type, typed);
     }
 
 } // namespace vast::hl
@@ -0,0 +1,698 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/IR/PatternMatch.h>
+#include <mlir/Interfaces/DataLayoutInterfaces.h>
+
+#include <llvm/ADT/APFloat.h>
+#include <llvm/ADT/APSInt.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/HighLevel/HighLevelDialect.hpp"
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
+
+#include "vast/Dialect/Core/CoreAttributes.hpp"
+
+#include "vast/Util/Common.hpp"
+#include "vast/Util/DataLayout.hpp"
+
+#include <functional>
+#include <optional>
+
+// Folds follow C semantics of the operations: unsigned arithmetic wraps, while
+// operations with undefined behaviour (signed overflow, division by zero,
+// out of range shifts) are left to the runtime. Bit widths of types are taken
+// from the data layout of the module.
+namespace vast::hl
+{
+    using FoldResult = mlir::OpFoldResult;
+
+    using apsint  = llvm::APSInt;
+    using apfloat = llvm::APFloat;
+
+    namespace
+    {
+        std::optional< unsigned > bit_width(operation op, mlir_type type)
+        {
+            auto mod = op->getParentOfType< vast_module >();
+            if (!mod)
+                return std::nullopt;
+
+            auto spec = mod.getDataLayoutSpec();
+            if (!spec)
+                return std::nullopt;
+
+            for (auto entry : spec.getEntries()) {
+                auto key = mlir::dyn_cast< mlir_type >(entry.getKey());
+                if (key && key == type)
+                    return dl::DLEntry(entry).bw;
+            }
+
+            return std::nullopt;
+        }
+
+        std::optional< apsint > int_value(mlir::Attribute attr)
+        {
+            if (auto value = mlir::dyn_cast_or_null< core::IntegerAttr >(attr))
+                return value.getValue();
+            return std::nullopt;
+        }
+
+        // The value stored in an integer constant has neither the width nor the
+        // signedness of its type, e.g., parsed constants are as wide as their
+        // digits need. Folds work on the value normalized to its type.
+        std::optional< apsint > int_value(operation op, mlir::Attribute attr)
+        {
+            auto value = int_value(attr);
+            if (!value)
+                return std::nullopt;
+
+            auto type  = mlir::cast< mlir::TypedAttr >(attr).getType();
+            auto width = bit_width(op, type);
+            if (!width)
+                return std::nullopt;
+
+            auto result = value->extOrTrunc(*width);
+            result.setIsUnsigned(isUnsigned(type));
+            return result;
+        }
+
+        std::optional< apfloat > float_value(mlir::Attribute attr)
+        {
+            if (auto value = mlir::dyn_cast_or_null< core::FloatAttr >(attr))
+                return value.getValue();
+            return std::nullopt;
+        }
+
+        std::optional< bool > truth_value(mlir::Attribute attr)
+        {
+            if (auto value = mlir::dyn_cast_or_null< core::BooleanAttr >(attr))
+                return value.getValue();
+            if (auto value = int_value(attr))
+                return !value->isZero();
+            if (auto value = float_value(attr))
+                return !value->isZero();
+            return std::nullopt;
+        }
+
+        bool is_int_constant(mlir::Attribute attr, auto &&pred)
+        {
+            auto value = int_value(attr);
+            return value && pred(*value);
+        }
+
+        bool is_zero(mlir::Attribute attr)
+        {
+            return is_int_constant(attr, [] (const auto &v) { return v.isZero(); });
+        }
+
+        bool is_one(mlir::Attribute attr)
+        {
+            return is_int_constant(attr, [] (const auto &v) { return v.isOne(); });
+        }
+
+        bool is_all_ones(operation op, mlir::Attribute attr)
+        {
+            auto value = int_value(op, attr);
+            return value && value->isAllOnes();
+        }
+
+        // Boolean results of comparisons and logical negation are either of
+        // `bool` type (C++) or `int` (C).
+        FoldResult make_truth(operation op, mlir_type type, bool value)
+        {
+            if (isBoolType(type))
+                return core::BooleanAttr::get(type, value);
+
+            if (!isIntegerType(type))
+                return {};
+
+            auto width = bit_width(op, type);
+            if (!width)
+                return {};
+            return core::IntegerAttr::get(type, apsint(llvm::APInt(*width, value), isUnsigned(type)));
+        }
+
+        // Returns `value` if it can replace the result of `op` as is.
+        FoldResult forward(operation op, mlir_value value)
+        {
+            if (value.getType() != op->getResult(0).getType())
+                return {};
+            return value;
+        }
+
+        using int_fold_t = std::function< std::optional< apsint >(const apsint &, const apsint &) >;
+
+        FoldResult fold_int_binary(operation op, mlir::Attribute lhs, mlir::Attribute rhs, int_fold_t fold)
+        {
+            auto l = int_value(op, lhs);
+            auto r = int_value(op, rhs);
+            if (!l || !r)
+                return {};
+
+            auto type = op->getResult(0).getType();
+            if (mlir::cast< mlir::TypedAttr >(lhs).getType() != type)
+                return {};
+            if (mlir::cast< mlir::TypedAttr >(rhs).getType() != type)
+                return {};
+
+            if (auto result = fold(*l, *r))
+                return core::IntegerAttr::get(type, *result);
+            return {};
+        }
+
+        // Applies an operation that may overflow, signed overflow is undefined.
+        std::optional< apsint > checked(const apsint &l, const apsint &r, auto sop, auto uop)
+        {
+            if (l.isUnsigned())
+                return apsint(uop(l, r), true);
+
+            bool overflow = false;
+            auto result = (l.*sop)(r, overflow);
+            if (overflow)
+                return std::nullopt;
+            return apsint(result, false);
+        }
+
+        using float_fold_t = std::function< apfloat(apfloat, const apfloat &) >;
+
+        FoldResult fold_float_binary(operation op, mlir::Attribute lhs, mlir::Attribute rhs, float_fold_t fold)
+        {
+            auto l = float_value(lhs);
+            auto r = float_value(rhs);
+            if (!l || !r || &l->getSemantics() != &r->getSemantics())
+                return {};
+
+            auto type = op->getResult(0).getType();
+            if (mlir::cast< mlir::TypedAttr >(lhs).getType() != type)
+                return {};
+            return core::FloatAttr::get(type, fold(*l, *r));
+        }
+
+        const llvm::fltSemantics *float_semantics(mlir_type type)
+        {
+            if (!isFloatingType(type))
+                return nullptr;
+            return &mlir::cast< mlir::FloatType >(to_std_float_type(type)).getFloatSemantics();
+        }
+
+        // Extension follows the signedness of the source type.
+        FoldResult fold_int_cast(operation op, mlir::Attribute value, mlir_type type)
+        {
+            auto v = int_value(op, value);
+            if (!v || !isIntegerType(type))
+                return {};
+
+            auto width = bit_width(op, type);
+            if (!width)
+                return {};
+            return core::IntegerAttr::get(type, apsint(v->extOrTrunc(*width), isUnsigned(type)));
+        }
+
+        FoldResult fold_int_to_float(operation op, mlir::Attribute value, mlir_type type)
+        {
+            auto v = int_value(op, value);
+            auto semantics = float_semantics(type);
+            if (!v || !semantics)
+                return {};
+
+            apfloat result(*semantics);
+            result.convertFromAPInt(*v, v->isSigned(), apfloat::rmNearestTiesToEven);
+            return core::FloatAttr::get(type, result);
+        }
+
+        FoldResult fold_float_cast(mlir::Attribute value, mlir_type type)
+        {
+            auto v = float_value(value);
+            auto semantics = float_semantics(type);
+            if (!v || !semantics)
+                return {};
+
+            bool loses_info = false;
+            v->convert(*semantics, apfloat::rmNearestTiesToEven, &loses_info);
+            return core::FloatAttr::get(type, *v);
+        }
+
+        // Conversion of a value that does not fit the integer type is undefined.
+        FoldResult fold_float_to_int(operation op, mlir::Attribute value, mlir_type type)
+        {
+            auto v = float_value(value);
+            if (!v || !isIntegerType(type))
+                return {};
+
+            auto width = bit_width(op, type);
+            if (!width)
+                return {};
+
+            apsint result(*width, isUnsigned(type));
+            bool exact = false;
+            auto status = v->convertToInteger(result, apfloat::rmTowardZero, &exact);
+            if (status & apfloat::opInvalidOp)
+                return {};
+            return core::IntegerAttr::get(type, result);
+        }
+
+        // Integral casts of integral casts that only widen and narrow back.
+        FoldResult fold_cast_of_cast(operation op, mlir_value value)
+        {
+            auto type  = op->getResult(0).getType();
+            auto inner = value.getDefiningOp();
+            if (!mlir::isa_and_nonnull< ImplicitCastOp, CStyleCastOp >(inner))
+                return {};
+
+            auto inner_kind = mlir::isa< ImplicitCastOp >(inner)
+                ? mlir::cast< ImplicitCastOp >(inner).getKind()
+                : mlir::cast< CStyleCastOp >(inner).getKind();
+            if (inner_kind != CastKind::IntegralCast)
+                return {};
+
+            auto source = inner->getOperand(0);
+            if (source.getType() != type)
+                return {};
+
+            auto source_width = bit_width(op, type);
+            auto middle_width = bit_width(op, value.getType());
+            if (!source_width || !middle_width || *middle_width < *source_width)
+                return {};
+            return source;
+        }
+
+        FoldResult fold_cast(operation op, CastKind kind, mlir_value value, mlir::Attribute attr)
+        {
+            auto type = op->getResult(0).getType();
+
+            switch (kind) {
+                case CastKind::NoOp:
+                    return forward(op, value);
+                case CastKind::IntegralCast:
+                    if (value.getType() == type)
+                        return value;
+                    if (attr)
+                        return fold_int_cast(op, attr, type);
+                    return fold_cast_of_cast(op, value);
+                case CastKind::IntegralToBoolean:
+                case CastKind::FloatingToBoolean:
+                    if (auto truth = truth_value(attr); truth && isBoolType(type))
+                        return core::BooleanAttr::get(type, *truth);
+                    return {};
+                case CastKind::IntegralToFloating:
+                    return fold_int_to_float(op, attr, type);
+                case CastKind::FloatingCast:
+                    if (value.getType() == type)
+                        return value;
+                    return fold_float_cast(attr, type);
+                case CastKind::FloatingToIntegral:
+                    return fold_float_to_int(op, attr, type);
+                default:
+                    return {};
+            }
+        }
+
+        std::optional< bool > compare(Predicate pred, const apsint &l, const apsint &r)
+        {
+            switch (pred) {
+                case Predicate::eq:  return l.eq(r);
+                case Predicate::ne:  return l.ne(r);
+                case Predicate::slt: return l.slt(r);
+                case Predicate::sle: return l.sle(r);
+                case Predicate::sgt: return l.sgt(r);
+                case Predicate::sge: return l.sge(r);
+                case Predicate::ult: return l.ult(r);
+                case Predicate::ule: return l.ule(r);
+                case Predicate::ugt: return l.ugt(r);
+                case Predicate::uge: return l.uge(r);
+            }
+            return std::nullopt;
+        }
+
+        bool is_reflexive(Predicate pred)
+        {
+            switch (pred) {
+                case Predicate::eq:
+                case Predicate::sle: case Predicate::sge:
+                case Predicate::ule: case Predicate::uge:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        bool compare(FPredicate pred, const apfloat &l, const apfloat &r)
+        {
+            auto res = l.compare(r);
+            bool unordered = res == apfloat::cmpUnordered;
+            bool eq = res == apfloat::cmpEqual;
+            bool lt = res == apfloat::cmpLessThan;
+            bool gt = res == apfloat::cmpGreaterThan;
+
+            switch (pred) {
+                case FPredicate::ffalse: return false;
+                case FPredicate::oeq:    return eq;
+                case FPredicate::ogt:    return gt;
+                case FPredicate::oge:    return gt || eq;
+                case FPredicate::olt:    return lt;
+                case FPredicate::ole:    return lt || eq;
+                case FPredicate::one:    return lt || gt;
+                case FPredicate::ord:    return !unordered;
+                case FPredicate::uno:    return unordered;
+                case FPredicate::ueq:    return unordered || eq;
+                case FPredicate::ugt:    return unordered || gt;
+                case FPredicate::uge:    return unordered || gt || eq;
+                case FPredicate::ult:    return unordered || lt;
+                case FPredicate::ule:    return unordered || lt || eq;
+                case FPredicate::une:    return !eq;
+                case FPredicate::ftrue:  return true;
+            }
+            VAST_UNREACHABLE("unknown floating point predicate");
+        }
+
+        Predicate invert(Predicate pred)
+        {
+            switch (pred) {
+                case Predicate::eq:  return Predicate::ne;
+                case Predicate::ne:  return Predicate::eq;
+                case Predicate::slt: return Predicate::sge;
+                case Predicate::sle: return Predicate::sgt;
+                case Predicate::sgt: return Predicate::sle;
+                case Predicate::sge: return Predicate::slt;
+                case Predicate::ult: return Predicate::uge;
+                case Predicate::ule: return Predicate::ugt;
+                case Predicate::ugt: return Predicate::ule;
+                case Predicate::uge: return Predicate::ult;
+            }
+            VAST_UNREACHABLE("unknown predicate");
+        }
+
+    } // namespace
+
+    //===----------------------------------------------------------------------===//
+    // Integer arithmetic
+    //===----------------------------------------------------------------------===//
+
+    FoldResult AddIOp::fold(FoldAdaptor adaptor) {
+        if (is_zero(adaptor.getRhs()))
+            return forward(*this, getLhs());
+        if (is_zero(adaptor.getLhs()))
+            return forward(*this, getRhs());
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(), [] (const auto &l, const auto &r) {
+            return checked(l, r, &llvm::APInt::sadd_ov, std::plus< llvm::APInt >());
+        });
+    }
+
+    FoldResult SubIOp::fold(FoldAdaptor adaptor) {
+        if (is_zero(adaptor.getRhs()))
+            return forward(*this, getLhs());
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(), [] (const auto &l, const auto &r) {
+            return checked(l, r, &llvm::APInt::ssub_ov, std::minus< llvm::APInt >());
+        });
+    }
+
+    FoldResult MulIOp::fold(FoldAdaptor adaptor) {
+        if (is_one(adaptor.getRhs()))
+            return forward(*this, getLhs());
+        if (is_one(adaptor.getLhs()))
+            return forward(*this, getRhs());
+        if (is_zero(adaptor.getRhs()))
+            return forward(*this, getRhs());
+        if (is_zero(adaptor.getLhs()))
+            return forward(*this, getLhs());
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(), [] (const auto &l, const auto &r) {
+            return checked(l, r, &llvm::APInt::smul_ov, std::multiplies< llvm::APInt >());
+        });
+    }
+
+    FoldResult DivSOp::fold(FoldAdaptor adaptor) {
+        if (is_one(adaptor.getRhs()))
+            return forward(*this, getLhs());
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(), [] (const auto &l, const auto &r)
+            -> std::optional< apsint >
+        {
+            if (r.isZero())
+                return std::nullopt;
+            bool overflow = false;
+            auto result = l.sdiv_ov(r, overflow);
+            if (overflow)
+                return std::nullopt;
+            return apsint(result, l.isUnsigned());
+        });
+    }
+
+    FoldResult DivUOp::fold(FoldAdaptor adaptor) {
+        if (is_one(adaptor.getRhs()))
+            return forward(*this, getLhs());
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(), [] (const auto &l, const auto &r)
+            -> std::optional< apsint >
+        {
+            if (r.isZero())
+                return std::nullopt;
+            return apsint(l.udiv(r), l.isUnsigned());
+        });
+    }
+
+    // `INT_MIN % -1` is undefined, as the corresponding division overflows.
+    FoldResult RemSOp::fold(FoldAdaptor adaptor) {
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(), [] (const auto &l, const auto &r)
+            -> std::optional< apsint >
+        {
+            if (r.isZero())
+                return std::nullopt;
+            bool overflow = false;
+            (void) l.sdiv_ov(r, overflow);
+            if (overflow)
+                return std::nullopt;
+            return apsint(l.srem(r), l.isUnsigned());
+        });
+    }
+
+    FoldResult RemUOp::fold(FoldAdaptor adaptor) {
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(), [] (const auto &l, const auto &r)
+            -> std::optional< apsint >
+        {
+            if (r.isZero())
+                return std::nullopt;
+            return apsint(l.urem(r), l.isUnsigned());
+        });
+    }
+
+    FoldResult BinAndOp::fold(FoldAdaptor adaptor) {
+        if (is_all_ones(*this, adaptor.getRhs()))
+            return forward(*this, getLhs());
+        if (is_zero(adaptor.getRhs()))
+            return forward(*this, getRhs());
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(), [] (const auto &l, const auto &r) {
+            return std::optional< apsint >(l & r);
+        });
+    }
+
+    FoldResult BinOrOp::fold(FoldAdaptor adaptor) {
+        if (is_zero(adaptor.getRhs()))
+            return forward(*this, getLhs());
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(), [] (const auto &l, const auto &r) {
+            return std::optional< apsint >(l | r);
+        });
+    }
+
+    FoldResult BinXorOp::fold(FoldAdaptor adaptor) {
+        if (is_zero(adaptor.getRhs()))
+            return forward(*this, getLhs());
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(), [] (const auto &l, const auto &r) {
+            return std::optional< apsint >(l ^ r);
+        });
+    }
+
+    //===----------------------------------------------------------------------===//
+    // Shifts
+    //===----------------------------------------------------------------------===//
+
+    namespace
+    {
+        // Shift amounts are not converted to the type of the shifted value,
+        // negative amounts and amounts of at least the width are undefined.
+        std::optional< unsigned > shift_amount(operation op, mlir::Attribute attr, unsigned width)
+        {
+            auto amount = int_value(op, attr);
+            if (!amount || (amount->isSigned() && amount->isNegative()))
+                return std::nullopt;
+            if (amount->uge(width))
+                return std::nullopt;
+            return static_cast< unsigned >(amount->getZExtValue());
+        }
+
+        FoldResult fold_shift(operation op, mlir::Attribute lhs, mlir::Attribute rhs, auto &&fold)
+        {
+            auto value = int_value(op, lhs);
+            if (!value)
+                return {};
+
+            auto type = op->getResult(0).getType();
+            if (mlir::cast< mlir::TypedAttr >(lhs).getType() != type)
+                return {};
+
+            auto amount = shift_amount(op, rhs, value->getBitWidth());
+            if (!amount)
+                return {};
+
+            if (auto result = fold(*value, *amount))
+                return core::IntegerAttr::get(type, *result);
+            return {};
+        }
+
+    } // namespace
+
+    // Left shifts of negative values and shifts of signed values that do not
+    // fit the result are undefined.
+    FoldResult BinShlOp::fold(FoldAdaptor adaptor) {
+        if (is_zero(adaptor.getRhs()))
+            return forward(*this, getLhs());
+        return fold_shift(*this, adaptor.getLhs(), adaptor.getRhs(), [] (const apsint &v, unsigned amount)
+            -> std::optional< apsint >
+        {
+            if (v.isUnsigned())
+                return apsint(v.shl(amount), true);
+            if (v.isNegative())
+                return std::nullopt;
+
+            bool overflow = false;
+            auto result = v.sshl_ov(amount, overflow);
+            if (overflow)
+                return std::nullopt;
+            return apsint(result, false);
+        });
+    }
+
+    FoldResult BinLShrOp::fold(FoldAdaptor adaptor) {
+        if (is_zero(adaptor.getRhs()))
+            return forward(*this, getLhs());
+        return fold_shift(*this, adaptor.getLhs(), adaptor.getRhs(), [] (const apsint &v, unsigned amount) {
+            return std::optional< apsint >(apsint(v.lshr(amount), v.isUnsigned()));
+        });
+    }
+
+    FoldResult BinAShrOp::fold(FoldAdaptor adaptor) {
+        if (is_zero(adaptor.getRhs()))
+            return forward(*this, getLhs());
+        return fold_shift(*this, adaptor.getLhs(), adaptor.getRhs(), [] (const apsint &v, unsigned amount) {
+            return std::optional< apsint >(apsint(v.ashr(amount), v.isUnsigned()));
+        });
+    }
+
+    //===----------------------------------------------------------------------===//
+    // Floating point arithmetic
+    //===----------------------------------------------------------------------===//
+
+    FoldResult AddFOp::fold(FoldAdaptor adaptor) {
+        return fold_float_binary(*this, adaptor.getLhs(), adaptor.getRhs(), [] (apfloat l, const apfloat &r) {
+            l.add(r, apfloat::rmNearestTiesToEven);
+            return l;
+        });
+    }
+
+    FoldResult SubFOp::fold(FoldAdaptor adaptor) {
+        return fold_float_binary(*this, adaptor.getLhs(), adaptor.getRhs(), [] (apfloat l, const apfloat &r) {
+            l.subtract(r, apfloat::rmNearestTiesToEven);
+            return l;
+        });
+    }
+
+    FoldResult MulFOp::fold(FoldAdaptor adaptor) {
+        return fold_float_binary(*this, adaptor.getLhs(), adaptor.getRhs(), [] (apfloat l, const apfloat &r) {
+            l.multiply(r, apfloat::rmNearestTiesToEven);
+            return l;
+        });
+    }
+
+    FoldResult DivFOp::fold(FoldAdaptor adaptor) {
+        return fold_float_binary(*this, adaptor.getLhs(), adaptor.getRhs(), [] (apfloat l, const apfloat &r) {
+            l.divide(r, apfloat::rmNearestTiesToEven);
+            return l;
+        });
+    }
+
+    //===----------------------------------------------------------------------===//
+    // Unary operations
+    //===----------------------------------------------------------------------===//
+
+    FoldResult PlusOp::fold(FoldAdaptor) { return getArg(); }
+
+    FoldResult MinusOp::fold(FoldAdaptor adaptor) {
+        if (auto v = int_value(*this, adaptor.getArg())) {
+            if (v->isSigned() && v->isMinSignedValue())
+                return {};
+            return core::IntegerAttr::get(getType(), apsint(-*v, v->isUnsigned()));
+        }
+
+        if (auto v = float_value(adaptor.getArg())) {
+            v->changeSign();
+            return core::FloatAttr::get(getType(), *v);
+        }
+
+        return {};
+    }
+
+    FoldResult NotOp::fold(FoldAdaptor adaptor) {
+        if (auto v = int_value(*this, adaptor.getArg()))
+            return core::IntegerAttr::get(getType(), apsint(~*v, v->isUnsigned()));
+        return {};
+    }
+
+    FoldResult LNotOp::fold(FoldAdaptor adaptor) {
+        if (auto truth = truth_value(adaptor.getArg()))
+            return make_truth(*this, getType(), !*truth);
+        return {};
+    }
+
+    // Negation of a comparison is the inverted comparison.
+    logical_result LNotOp::canonicalize(LNotOp op, mlir::PatternRewriter &rewriter) {
+        auto cmp = op.getArg().getDefiningOp< CmpOp >();
+        if (!cmp || !cmp->hasOneUse() || cmp.getType() != op.getType())
+            return mlir::failure();
+
+        rewriter.replaceOpWithNewOp< CmpOp >(
+            op, op.getType(), invert(cmp.getPredicate()), cmp.getLhs(), cmp.getRhs()
+        );
+        rewriter.eraseOp(cmp);
+        return mlir::success();
+    }
+
+    //===----------------------------------------------------------------------===//
+    // Comparisons
+    //===----------------------------------------------------------------------===//
+
+    FoldResult CmpOp::fold(FoldAdaptor adaptor) {
+        if (getLhs() == getRhs() && isIntegerType(getLhs().getType()))
+            return make_truth(*this, getType(), is_reflexive(getPredicate()));
+
+        auto l = int_value(*this, adaptor.getLhs());
+        auto r = int_value(*this, adaptor.getRhs());
+        if (!l || !r || l->getBitWidth() != r->getBitWidth())
+            return {};
+
+        if (auto result = compare(getPredicate(), *l, *r))
+            return make_truth(*this, getType(), *result);
+        return {};
+    }
+
+    FoldResult FCmpOp::fold(FoldAdaptor adaptor) {
+        auto l = float_value(adaptor.getLhs());
+        auto r = float_value(adaptor.getRhs());
+        if (!l || !r || &l->getSemantics() != &r->getSemantics())
+            return {};
+        return make_truth(*this, getType(), compare(getPredicate(), *l, *r));
+    }
+
+    //===----------------------------------------------------------------------===//
+    // Casts
+    //===----------------------------------------------------------------------===//
+
+    FoldResult ImplicitCastOp::fold(FoldAdaptor adaptor) {
+        return fold_cast(*this, getKind(), getValue(), adaptor.getValue());
+    }
+
+    FoldResult CStyleCastOp::fold(FoldAdaptor adaptor) {
+        return fold_cast(*this, getKind(), getValue(), adaptor.getValue());
+    }
+
+} // namespace vast::hl
@@ -61,23 +61,28 @@ namespace vast::hl
             return is_one_of< hl::ReturnOp, hl::BreakOp, hl::ContinueOp >( op );
         }
 
-        void simplify( mlir::Block &block )
+        // Code after labels can be reached by a jump, even if it follows
+        // a terminator (e.g. `case` labels after a `break` in a switch).
+        bool is_label_like( mlir::Operation *op )
         {
-            auto breakpoint = simplify_until_terminator( block );
-            while ( breakpoint != block.end() )
-                to_erase.emplace_back( &*( breakpoint++ ) );
+            return is_one_of< hl::CaseOp, hl::DefaultOp, hl::LabelStmt >( op );
         }
 
-        auto simplify_until_terminator( mlir::Block &block )
-            -> mlir::Block::iterator
+        void simplify( mlir::Block &block )
         {
-            for ( auto it = block.begin(); it != block.end(); std::advance( it, 1 ) )
+            bool reachable = true;
+            for ( auto &op : block )
             {
-                if ( is_terminator_like( &*it ) )
-                    return std::next( it );
-                simplify( &*it );
+                if ( is_label_like( &op ) )
+                    reachable = true;
+
+                if ( !reachable )
+                    to_erase.emplace_back( &op );
+                else if ( is_terminator_like( &op ) )
+                    reachable = false;
+                else
+                    simplify( &op );
             }
-            return block.end();
         }
 
         void runOnOperation() override
@@ -0,0 +1,165 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#include "vast/Dialect/HighLevel/Passes.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/IR/Matchers.h>
+#include <mlir/IR/PatternMatch.h>
+#include <mlir/Rewrite/FrozenRewritePatternSet.h>
+#include <mlir/Rewrite/PatternApplicator.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Util/Common.hpp"
+
+#include "vast/Dialect/HighLevel/HighLevelDialect.hpp"
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+
+#include "PassesDetails.hpp"
+
+namespace vast::hl
+{
+    namespace
+    {
+        // Unlike the generic canonicalizer, the folder neither hoists constants
+        // to the entry block nor simplifies regions, so the structure of the
+        // high-level code stays intact.
+        struct folder
+        {
+            mlir::IRRewriter rewriter;
+            mlir::PatternApplicator applicator;
+
+            folder(mcontext_t *mctx, const mlir::FrozenRewritePatternSet &patterns)
+                : rewriter(mctx), applicator(patterns)
+            {
+                applicator.applyDefaultCostModel();
+            }
+
+            static bool is_foldable(operation op)
+            {
+                return mlir::isa_and_nonnull< HighLevelDialect >(op->getDialect())
+                    && op->getNumResults() == 1
+                    && !op->hasTrait< mlir::OpTrait::ConstantLike >();
+            }
+
+            mlir_value materialize(operation op, mlir::OpFoldResult result)
+            {
+                if (auto value = result.dyn_cast< mlir_value >())
+                    return value;
+
+                rewriter.setInsertionPoint(op);
+                auto type = op->getResult(0).getType();
+                auto constant = op->getDialect()->materializeConstant(
+                    rewriter, result.get< mlir::Attribute >(), type, op->getLoc()
+                );
+                return constant ? constant->getResult(0) : mlir_value();
+            }
+
+            // Constants that fed only the folded operation are dead now.
+            void erase_dead_operands(llvm::ArrayRef< operation > defs)
+            {
+                for (auto def : defs) {
+                    if (def && mlir::isa< ConstantOp >(def) && def->use_empty())
+                        def->erase();
+                }
+            }
+
+            bool fold(operation op)
+            {
+                llvm::SmallVector< mlir::Attribute > constants;
+                llvm::SmallVector< operation > defs;
+                for (auto operand : op->getOperands()) {
+                    mlir::Attribute attr;
+                    mlir::matchPattern(operand, mlir::m_Constant(&attr));
+                    constants.push_back(attr);
+                    defs.push_back(operand.getDefiningOp());
+                }
+
+                // In-place folds are not produced by hl operations.
+                llvm::SmallVector< mlir::OpFoldResult > results;
+                if (mlir::failed(op->fold(constants, results)) || results.empty())
+                    return false;
+
+                auto replacement = materialize(op, results.front());
+                if (!replacement)
+                    return false;
+
+                op->getResult(0).replaceAllUsesWith(replacement);
+                op->erase();
+                erase_dead_operands(defs);
+                return true;
+            }
+
+            bool canonicalize(operation op)
+            {
+                // Patterns may erase other operand definitions than constants.
+                llvm::SmallVector< operation > defs;
+                for (auto operand : op->getOperands()) {
+                    if (auto def = operand.getDefiningOp< ConstantOp >())
+                        defs.push_back(def);
+                }
+
+                rewriter.setInsertionPoint(op);
+                if (mlir::failed(applicator.matchAndRewrite(op, rewriter)))
+                    return false;
+
+                erase_dead_operands(defs);
+                return true;
+            }
+
+            // Operations are visited in post-order, so operands are folded
+            // before their users. Rewrites only erase the visited operation
+            // and operations preceding it.
+            std::size_t run(operation root)
+            {
+                std::size_t folded = 0;
+                bool changed = true;
+                while (changed) {
+                    changed = false;
+
+                    llvm::SmallVector< operation > ops;
+                    root->walk< mlir::WalkOrder::PostOrder >([&] (operation op) {
+                        if (is_foldable(op))
+                            ops.push_back(op);
+                    });
+
+                    for (auto op : ops) {
+                        if (fold(op)) {
+                            ++folded;
+                            changed = true;
+                        } else if (canonicalize(op)) {
+                            changed = true;
+                        }
+                    }
+                }
+                return folded;
+            }
+        };
+
+    } // namespace
+
+    struct HLFold : HLFoldBase< HLFold >
+    {
+        mlir::FrozenRewritePatternSet patterns;
+
+        logical_result initialize(mcontext_t *mctx) override
+        {
+            mlir::RewritePatternSet set(mctx);
+            for (auto name : mctx->getRegisteredOperations()) {
+                if (name.getDialectNamespace() == HighLevelDialect::getDialectNamespace())
+                    name.getCanonicalizationPatterns(set, mctx);
+            }
+            patterns = std::move(set);
+            return mlir::success();
+        }
+
+        void runOnOperation() override
+        {
+            folded += folder(&getContext(), patterns).run(getOperation());
+        }
+    };
+
+    std::unique_ptr< mlir::Pass > createHLFoldPass()
+    {
+        return std::make_unique< HLFold >();
+    }
+} // namespace vast::hl
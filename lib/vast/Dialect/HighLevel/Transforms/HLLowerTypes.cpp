@@ -17,6 +17,7 @@ VAST_UNRELAX_WARNINGS
 #include "vast/Dialect/HighLevel/HighLevelOps.hpp"
 #include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
 
+#include "vast/Dialect/Core/CoreDialect.hpp"
 #include "vast/Dialect/Core/CoreTypes.hpp"
 #include "vast/Dialect/Core/CoreAttributes.hpp"
 
@@ -166,12 +167,46 @@ namespace vast::hl
         }
     };
 
+    // Arrays are as qualified as their elements.
+    bool is_read_only(mlir_type type) {
+        if (auto array = mlir::dyn_cast< ArrayType >(type)) {
+            return is_read_only(array.getElementType());
+        }
+
+        bool is_const = false, is_volatile = false;
+        type.walkImmediateSubElements([&] (mlir::Attribute attr) {
+            if (auto quals = mlir::dyn_cast< ConstQualifierInterface >(attr)) {
+                is_const |= quals.hasConst();
+            }
+            if (auto quals = mlir::dyn_cast< VolatileQualifierInterface >(attr)) {
+                is_volatile |= quals.hasVolatile();
+            }
+        }, [] (mlir_type) {});
+
+        return is_const && !is_volatile;
+    }
+
     struct HLLowerTypesPass : HLLowerTypesBase< HLLowerTypesPass >
     {
+        // Qualifiers are gone with the high-level types, globals that can be
+        // placed in read-only memory are marked before.
+        void mark_constant_globals(operation op) {
+            op->walk([&] (VarDeclOp var) {
+                auto type = mlir::dyn_cast< LValueType >(var.getType());
+                if (var.hasGlobalStorage() && type && is_read_only(type.getElementType())) {
+                    var->setAttr(
+                        core::CoreDialect::getConstantAttrName(), mlir::UnitAttr::get(&getContext())
+                    );
+                }
+            });
+        }
+
         void runOnOperation() override {
             auto op    = this->getOperation();
             auto &mctx = this->getContext();
 
+            mark_constant_globals(op);
+
             mlir::ConversionTarget trg(mctx);
             // We want to check *everything* for presence of hl type
             // that can be lowered.
@@ -0,0 +1,215 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#include "vast/Dialect/HighLevel/Passes.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/IR/Builders.h>
+#include <mlir/IR/BuiltinAttributes.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Util/Common.hpp"
+
+#include "vast/Dialect/HighLevel/HighLevelDialect.hpp"
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
+
+#include "PassesDetails.hpp"
+#include "Profile.hpp"
+
+namespace vast::hl
+{
+    namespace
+    {
+        using namespace profile::runtime;
+
+        // Each counter increments its slot of the module counter array. The
+        // key table holds one newline terminated key per counter. Increments
+        // are marker calls lowered to inline atomic adds, the array is
+        // registered with the runtime once by a module constructor.
+        struct instrumenter
+        {
+            vast_module mod;
+            mlir::OpBuilder bld;
+
+            std::vector< profile::counted_region > sites = {};
+            std::string keys = {};
+
+            explicit instrumenter(vast_module mod)
+                : mod(mod), bld(mod.getContext())
+            {}
+
+            mcontext_t *mctx() { return mod.getContext(); }
+
+            mlir_type counter_type() { return bld.getIntegerType(64, false); }
+            mlir_type index_type() { return bld.getIntegerType(32, false); }
+            mlir_type key_char_type() { return bld.getIntegerType(8, true); }
+
+            mlir::DenseElementsAttr key_table()
+            {
+                llvm::SmallVector< llvm::APInt > chars;
+                for (auto c : keys)
+                    chars.emplace_back(8, static_cast< uint64_t >(c), true);
+                chars.emplace_back(8, 0);
+                auto type = mlir::RankedTensorType::get(
+                    { static_cast< int64_t >(chars.size()) }, bld.getIntegerType(8)
+                );
+                return mlir::DenseElementsAttr::get(type, chars);
+            }
+
+            void declare_global(
+                mlir::Location loc, llvm::StringRef name, ArrayType type, mlir::DenseElementsAttr value
+            ) {
+                auto init = [&] (auto &builder, auto loc) {
+                    auto dense = builder.template create< DenseInitListExpr >(loc, type, value);
+                    builder.template create< ValueYieldOp >(loc, dense.getResult());
+                };
+
+                auto var = bld.create< VarDeclOp >(loc, LValueType::get(mctx(), type), name, init);
+                var.setStorageClass(StorageClass::sc_static);
+            }
+
+            ArrayType counters_type()
+            {
+                return ArrayType::get(mctx(), sites.size(), counter_type());
+            }
+
+            ArrayType keys_type()
+            {
+                return ArrayType::get(mctx(), keys.size() + 1, key_char_type());
+            }
+
+            core::FunctionType increment_type()
+            {
+                return core::FunctionType::get(
+                    { PointerType::get(mctx(), counter_type()), index_type() },
+                    { VoidType::get(mctx()) }
+                );
+            }
+
+            core::FunctionType register_type()
+            {
+                return core::FunctionType::get(
+                    { PointerType::get(mctx(), counter_type()),
+                      PointerType::get(mctx(), key_char_type()),
+                      index_type() },
+                    { VoidType::get(mctx()) }
+                );
+            }
+
+            core::FunctionType init_type()
+            {
+                return core::FunctionType::get({}, { VoidType::get(mctx()) });
+            }
+
+            void declare_function(mlir::Location loc, llvm::StringRef name, core::FunctionType type)
+            {
+                auto fn = bld.create< FuncOp >(loc, name, type);
+                fn.setVisibility(mlir::SymbolTable::Visibility::Private);
+            }
+
+            void define_init(mlir::Location loc)
+            {
+                auto body = [&] (auto &, auto loc) {
+                    auto counters = decay(loc, counters_name, counters_type());
+                    auto keys     = decay(loc, keys_name, keys_type());
+                    auto count    = index(loc, sites.size());
+                    bld.create< CallOp >(
+                        loc, register_name, mlir::TypeRange{ VoidType::get(mctx()) },
+                        mlir::ValueRange{ counters, keys, count }
+                    );
+                    auto void_val = bld.create< ConstantOp >(loc, VoidType::get(mctx()));
+                    bld.create< ReturnOp >(loc, void_val.getResult());
+                };
+
+                bld.create< FuncOp >(
+                    loc, init_name, init_type(), core::GlobalLinkageKind::InternalLinkage,
+                    llvm::ArrayRef< mlir::NamedAttribute >{}, llvm::ArrayRef< mlir::DictionaryAttr >{},
+                    llvm::ArrayRef< mlir::DictionaryAttr >{}, body
+                );
+            }
+
+            void declare_runtime()
+            {
+                auto loc = mod.getLoc();
+                bld.setInsertionPointToStart(mod.getBody());
+
+                auto zero = mlir::DenseElementsAttr::get(
+                    mlir::RankedTensorType::get(
+                        { static_cast< int64_t >(sites.size()) }, bld.getIntegerType(64)
+                    ),
+                    llvm::APInt(64, 0)
+                );
+                declare_global(loc, counters_name, counters_type(), zero);
+                declare_global(loc, keys_name, keys_type(), key_table());
+
+                declare_function(loc, increment_name, increment_type());
+                declare_function(loc, register_name, register_type());
+                define_init(loc);
+            }
+
+            mlir_value decay(mlir::Location loc, llvm::StringRef global, ArrayType type)
+            {
+                auto ref = bld.create< GlobalRefOp >(loc, LValueType::get(mctx(), type), global);
+                return bld.create< ImplicitCastOp >(
+                    loc, PointerType::get(mctx(), type.getElementType()), ref,
+                    CastKind::ArrayToPointerDecay
+                );
+            }
+
+            mlir_value index(mlir::Location loc, std::size_t value)
+            {
+                return bld.create< ConstantOp >(
+                    loc, index_type(), llvm::APSInt(llvm::APInt(32, value), true)
+                );
+            }
+
+            void instrument(const profile::counted_region &site, unsigned idx)
+            {
+                bld.setInsertionPointToStart(&site.region->front());
+                auto counters = decay(site.loc, counters_name, counters_type());
+                bld.create< CallOp >(
+                    site.loc, increment_name, mlir::TypeRange{ VoidType::get(mctx()) },
+                    mlir::ValueRange{ counters, index(site.loc, idx) }
+                );
+            }
+
+            std::size_t run()
+            {
+                // The module is already instrumented.
+                for (auto fn : mod.getOps< FuncOp >()) {
+                    if (fn.getSymName() == increment_name)
+                        return 0;
+                }
+
+                sites = profile::counted_regions(mod);
+                for (const auto &site : sites) {
+                    keys += site.key;
+                    keys += '\n';
+                }
+
+                if (sites.empty())
+                    return 0;
+
+                declare_runtime();
+                for (auto [idx, site] : llvm::enumerate(sites))
+                    instrument(site, static_cast< unsigned >(idx));
+                return sites.size();
+            }
+        };
+
+    } // namespace
+
+    struct InstrumentProfile : InstrumentProfileBase< InstrumentProfile >
+    {
+        void runOnOperation() override
+        {
+            instrumenter inst{ getOperation() };
+            counters += inst.run();
+        }
+    };
+
+    std::unique_ptr< mlir::Pass > createInstrumentProfilePass()
+    {
+        return std::make_unique< InstrumentProfile >();
+    }
+} // namespace vast::hl
@@ -0,0 +1,130 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#include "Profile.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/IR/Location.h>
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/TypeSwitch.h>
+#include <llvm/Support/FormatVariadic.h>
+#include <llvm/Support/Path.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/Meta/MetaAttributes.hpp"
+
+#include <algorithm>
+
+namespace vast::hl::profile
+{
+    namespace
+    {
+        // Counters are keyed by the meta identifier of the instrumented
+        // operation if there is one, by its source location otherwise. Only
+        // the file name is used, so that profiles survive moving the build.
+        std::string location_key(mlir::Location loc)
+        {
+            if (auto fused = mlir::dyn_cast< mlir::FusedLoc >(loc)) {
+                if (auto id = mlir::dyn_cast_or_null< meta::IdentifierAttr >(fused.getMetadata()))
+                    return llvm::formatv("#{0}", id.getValue()).str();
+                for (auto inner : fused.getLocations()) {
+                    if (auto key = location_key(inner); !key.empty())
+                        return key;
+                }
+                return {};
+            }
+
+            if (auto file = mlir::dyn_cast< mlir::FileLineColLoc >(loc)) {
+                return llvm::formatv(
+                    "{0}:{1}:{2}", llvm::sys::path::filename(file.getFilename().getValue()),
+                    file.getLine(), file.getColumn()
+                ).str();
+            }
+
+            if (auto name = mlir::dyn_cast< mlir::NameLoc >(loc))
+                return location_key(name.getChildLoc());
+
+            return {};
+        }
+
+        struct collector
+        {
+            std::vector< counted_region > regions = {};
+            llvm::StringMap< unsigned > seen = {};
+
+            std::string make_key(llvm::StringRef fn, llvm::StringRef kind, mlir::Location loc)
+            {
+                auto key = llvm::formatv("{0}:{1}:{2}", fn, kind, location_key(loc)).str();
+                // Keys have to be unique, e.g. regions expanded from one macro
+                // share the location.
+                if (auto count = seen[key]++)
+                    key += llvm::formatv(".{0}", count).str();
+                // Newlines and tabs separate keys and counts in profile dumps.
+                std::replace_if(key.begin(), key.end(), [] (char c) {
+                    return c == '\n' || c == '\t';
+                }, '_');
+                return key;
+            }
+
+            void add(mlir::Region &region, llvm::StringRef fn, llvm::StringRef kind, mlir::Location loc)
+            {
+                if (region.empty())
+                    return;
+                regions.push_back({ &region, loc, make_key(fn, kind, loc) });
+            }
+
+            void collect(FuncOp fn)
+            {
+                auto name = fn.getSymName();
+                add(fn.getBody(), name, "entry", fn.getLoc());
+
+                fn.walk< mlir::WalkOrder::PreOrder >([&] (operation op) {
+                    llvm::TypeSwitch< operation >(op)
+                        .Case< IfOp >([&] (auto stmt) {
+                            add(stmt.getThenRegion(), name, "if.then", stmt.getLoc());
+                        })
+                        .Case< CondOp >([&] (auto stmt) {
+                            add(stmt.getThenRegion(), name, "cond.true", stmt.getLoc());
+                        })
+                        .Case< WhileOp >([&] (auto stmt) {
+                            add(stmt.getBodyRegion(), name, "while.body", stmt.getLoc());
+                        })
+                        .Case< ForOp >([&] (auto stmt) {
+                            add(stmt.getBodyRegion(), name, "for.body", stmt.getLoc());
+                        })
+                        .Case< DoOp >([&] (auto stmt) {
+                            add(stmt.getBodyRegion(), name, "do.body", stmt.getLoc());
+                        })
+                        .Case< CaseOp >([&] (auto stmt) {
+                            add(stmt.getBody(), name, "case", stmt.getLoc());
+                        })
+                        .Case< DefaultOp >([&] (auto stmt) {
+                            add(stmt.getBody(), name, "default", stmt.getLoc());
+                        })
+                        // Labels are entered by jumps too, their count can
+                        // not be derived from the enclosing region.
+                        .Case< LabelStmt >([&] (auto stmt) {
+                            add(stmt.getBody(), name, "label", stmt.getLoc());
+                        });
+                });
+            }
+        };
+
+    } // namespace
+
+    std::vector< counted_region > counted_regions(vast_module mod)
+    {
+        collector col;
+        for (auto fn : mod.getOps< FuncOp >()) {
+            if (!fn.isDeclaration() && !is_runtime(fn))
+                col.collect(fn);
+        }
+        return std::move(col.regions);
+    }
+
+    bool is_runtime(FuncOp fn)
+    {
+        return fn.getSymName().startswith("__vast_prof_");
+    }
+
+} // namespace vast::hl::profile
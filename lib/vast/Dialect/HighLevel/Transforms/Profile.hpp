@@ -0,0 +1,40 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/IR/Region.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Util/Common.hpp"
+
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+
+#include <string>
+#include <vector>
+
+namespace vast::hl::profile
+{
+    // Region that gets a counter. The key identifies the counter across
+    // builds of the same source.
+    struct counted_region
+    {
+        mlir::Region *region;
+        mlir::Location loc;
+        std::string key;
+    };
+
+    // Collects counted regions of all defined functions in the order of their
+    // counter indices. As in clang, only the entry of functions, then branches
+    // of `hl.if` and `hl.cond`, bodies of loops, switch cases and labels are
+    // counted. The remaining counts are derived by propagating counts through
+    // statements: the count after `hl.return`, `hl.break`, `hl.continue` and
+    // `hl.goto` is zero, the count after a statement adds up all its exits.
+    std::vector< counted_region > counted_regions(vast_module mod);
+
+    // Functions of the profiling runtime are never instrumented.
+    bool is_runtime(FuncOp fn);
+
+} // namespace vast::hl::profile
@@ -0,0 +1,344 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#include "vast/Dialect/HighLevel/Passes.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/IR/BuiltinAttributes.h>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/TypeSwitch.h>
+#include <llvm/Support/MemoryBuffer.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Util/Common.hpp"
+
+#include "vast/Dialect/Core/CoreDialect.hpp"
+#include "vast/Dialect/HighLevel/HighLevelDialect.hpp"
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+
+#include "PassesDetails.hpp"
+#include "Profile.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace vast::hl
+{
+    namespace
+    {
+        using counts_t = llvm::StringMap< std::uint64_t >;
+
+        // Parses `key<TAB>count` lines of the profiling runtime. Counts of
+        // repeated keys, e.g. from concatenated dumps of several runs, add up.
+        counts_t parse_profile(llvm::StringRef buffer)
+        {
+            counts_t counts;
+            llvm::SmallVector< llvm::StringRef > lines;
+            buffer.split(lines, '\n', -1, false);
+            for (auto line : lines) {
+                auto [key, value] = line.rtrim("\r").rsplit('\t');
+                std::uint64_t count = 0;
+                if (key.empty() || value.getAsInteger(10, count))
+                    continue;
+                counts[key] += count;
+            }
+            return counts;
+        }
+
+        std::uint64_t saturating_sub(std::uint64_t lhs, std::uint64_t rhs)
+        {
+            return lhs > rhs ? lhs - rhs : 0;
+        }
+
+        // Propagates counts from counted regions through the statements of a
+        // function, as clang does, and attaches branch weights to conditional
+        // operations. The count after `hl.return`, `hl.goto`, `hl.break` and
+        // `hl.continue` is zero, the count after a statement adds up all of
+        // its exits. Weights follow the order of successors of the lowered
+        // branches: true before false and the default destination of a
+        // switch before its cases.
+        struct annotator
+        {
+            const counts_t &counts;
+
+            llvm::DenseMap< mlir::Region *, std::uint64_t > region_counts = {};
+            std::size_t annotated = 0;
+
+            // Count of the point of the walk.
+            std::uint64_t current = 0;
+
+            // Counts of jumps to the exit or the next iteration of enclosing
+            // loops and switches.
+            struct jump_target
+            {
+                bool loop;
+                std::uint64_t breaks = 0;
+                std::uint64_t continues = 0;
+            };
+
+            std::vector< jump_target > targets = {};
+
+            // Direct entries of cases of enclosing switches, i.e. without
+            // fallthrough from the preceding case.
+            struct switch_cases
+            {
+                llvm::SmallVector< std::uint64_t > direct = {};
+                bool complete = true;
+            };
+
+            std::vector< switch_cases > switches = {};
+
+            std::optional< std::uint64_t > lookup(mlir::Region &region) const
+            {
+                if (auto it = region_counts.find(&region); it != region_counts.end())
+                    return it->second;
+                return std::nullopt;
+            }
+
+            void set_weights(operation op, llvm::ArrayRef< std::uint64_t > values)
+            {
+                // Weights are 32-bit in LLVM, only their ratio matters.
+                auto max   = *std::max_element(values.begin(), values.end());
+                auto scale = max / std::numeric_limits< std::int32_t >::max() + 1;
+
+                llvm::SmallVector< std::int32_t > weights;
+                for (auto value : values)
+                    weights.push_back(static_cast< std::int32_t >(value / scale));
+
+                op->setAttr(
+                    core::CoreDialect::getBranchWeightsAttrName(),
+                    mlir::DenseI32ArrayAttr::get(op->getContext(), weights)
+                );
+                ++annotated;
+            }
+
+            // Returns the count at the exit of the region entered `entry`
+            // times, unless the region is counted.
+            std::uint64_t visit_region(mlir::Region &region, std::uint64_t entry)
+            {
+                current = lookup(region).value_or(entry);
+                for (auto &block : region) {
+                    for (auto &nested : block)
+                        visit(&nested);
+                }
+                return current;
+            }
+
+            jump_target visit_loop_body(mlir::Region &body, std::uint64_t entry)
+            {
+                targets.push_back({ .loop = true });
+                visit_region(body, entry);
+                auto target = targets.back();
+                targets.pop_back();
+                return target;
+            }
+
+            template< typename op_t >
+            void annotate_conditional(op_t op)
+            {
+                auto parent = visit_region(op.getCondRegion(), current);
+                auto taken  = lookup(op.getThenRegion());
+                auto other  = saturating_sub(parent, taken.value_or(parent));
+                if (taken)
+                    set_weights(op, { *taken, other });
+
+                auto then_exit = visit_region(op.getThenRegion(), parent);
+                auto else_exit = visit_region(op.getElseRegion(), other);
+                current = then_exit + else_exit;
+            }
+
+            // Without the body count the loop is assumed to be left once per
+            // entry.
+            std::uint64_t exit_loop(
+                operation op, std::uint64_t cond, std::optional< std::uint64_t > body,
+                std::uint64_t parent
+            ) {
+                if (!body)
+                    return parent;
+                auto exit = saturating_sub(cond, *body);
+                set_weights(op, { *body, exit });
+                return exit;
+            }
+
+            // The condition is entered by the loop entry, the end of the body
+            // and continues, the loop is left through the condition or breaks.
+            void annotate(WhileOp op)
+            {
+                auto parent = current;
+                auto body   = lookup(op.getBodyRegion());
+                auto jumps  = visit_loop_body(op.getBodyRegion(), parent);
+
+                auto cond = visit_region(op.getCondRegion(), parent + current + jumps.continues);
+                current = exit_loop(op, cond, body, parent) + jumps.breaks;
+            }
+
+            void annotate(ForOp op)
+            {
+                auto parent = current;
+                auto body   = lookup(op.getBodyRegion());
+                auto jumps  = visit_loop_body(op.getBodyRegion(), parent);
+
+                auto incr = visit_region(op.getIncrRegion(), current + jumps.continues);
+                auto cond = visit_region(op.getCondRegion(), parent + incr);
+                current = exit_loop(op, cond, body, parent) + jumps.breaks;
+            }
+
+            // The body is entered by the loop entry and the taken backedges.
+            void annotate(DoOp op)
+            {
+                auto parent = current;
+                auto body   = lookup(op.getBodyRegion());
+                auto jumps  = visit_loop_body(op.getBodyRegion(), parent);
+
+                auto cond = visit_region(op.getCondRegion(), current + jumps.continues);
+                if (!body) {
+                    current = parent + jumps.breaks;
+                    return;
+                }
+
+                auto taken = saturating_sub(*body, parent);
+                auto exit  = saturating_sub(cond, taken);
+                set_weights(op, { taken, exit });
+                current = exit + jumps.breaks;
+            }
+
+            // Counts of cases include fallthrough from the preceding case,
+            // which is subtracted to get the weight of the dispatch edge.
+            void annotate(SwitchOp op)
+            {
+                auto parent = visit_region(op.getCondRegion(), current);
+
+                targets.push_back({ .loop = false });
+                switches.emplace_back();
+                // Statements before the first case are never executed.
+                std::uint64_t end = 0;
+                for (auto &cases : op.getCases())
+                    end = visit_region(cases, 0);
+                auto jumps = targets.back();
+                auto info  = switches.back();
+                targets.pop_back();
+                switches.pop_back();
+
+                std::uint64_t dispatched = 0;
+                for (auto count : info.direct)
+                    dispatched += count;
+                auto fallback = saturating_sub(parent, dispatched);
+
+                if (info.complete && !info.direct.empty()) {
+                    llvm::SmallVector< std::uint64_t > weights = { fallback };
+                    weights.append(info.direct.begin(), info.direct.end());
+                    set_weights(op, weights);
+                }
+
+                // Without a default label unmatched values leave the switch.
+                bool has_default = false;
+                op->walk([&] (DefaultOp label) {
+                    has_default |= label->getParentOfType< SwitchOp >() == op;
+                });
+
+                current = end + jumps.breaks + (has_default ? 0 : fallback);
+            }
+
+            template< typename op_t >
+            void visit_label(op_t label, bool is_case)
+            {
+                auto fallthrough = current;
+                auto count = lookup(label.getBody());
+                if (is_case && !switches.empty()) {
+                    auto &info = switches.back();
+                    info.complete &= count.has_value();
+                    info.direct.push_back(saturating_sub(count.value_or(0), fallthrough));
+                }
+                visit_region(label.getBody(), fallthrough);
+            }
+
+            // Breaks leave the innermost loop or switch, continues the
+            // innermost loop.
+            void jump(bool is_continue)
+            {
+                for (auto &target : llvm::reverse(targets)) {
+                    if (is_continue && !target.loop)
+                        continue;
+                    (is_continue ? target.continues : target.breaks) += current;
+                    break;
+                }
+                current = 0;
+            }
+
+            void visit_regions(operation op)
+            {
+                for (auto &region : op->getRegions())
+                    visit_region(region, current);
+            }
+
+            void visit(operation op)
+            {
+                llvm::TypeSwitch< operation >(op)
+                    .Case< IfOp, CondOp >([&] (auto stmt) { annotate_conditional(stmt); })
+                    .Case< WhileOp, ForOp, DoOp, SwitchOp >([&] (auto stmt) { annotate(stmt); })
+                    .Case< CaseOp >([&] (auto stmt) {
+                        visit_region(stmt.getLhs(), current);
+                        visit_label(stmt, true);
+                    })
+                    .Case< DefaultOp, LabelStmt >([&] (auto stmt) { visit_label(stmt, false); })
+                    .Case< BreakOp >([&] (auto) { jump(false); })
+                    .Case< ContinueOp >([&] (auto) { jump(true); })
+                    .Case< ReturnOp, GotoStmt, UnreachableOp >([&] (auto) { current = 0; })
+                    .Default([&] (operation) { visit_regions(op); });
+            }
+
+            std::size_t run(vast_module mod)
+            {
+                for (const auto &site : profile::counted_regions(mod)) {
+                    if (auto it = counts.find(site.key); it != counts.end())
+                        region_counts[ site.region ] = it->second;
+                }
+
+                // Functions missing in the profile are left without weights.
+                for (auto fn : mod.getOps< FuncOp >()) {
+                    if (lookup(fn.getBody()))
+                        visit_region(fn.getBody(), 0);
+                }
+
+                return annotated;
+            }
+        };
+
+    } // namespace
+
+    struct ProfileUse : ProfileUseBase< ProfileUse >
+    {
+        ProfileUse() = default;
+
+        explicit ProfileUse(std::string path) { profile = std::move(path); }
+
+        void runOnOperation() override
+        {
+            auto mod = getOperation();
+
+            auto buffer = llvm::MemoryBuffer::getFile(profile);
+            if (!buffer) {
+                mod.emitError() << "cannot read profile '" << profile << "': "
+                                << buffer.getError().message();
+                return signalPassFailure();
+            }
+
+            auto counts = parse_profile(buffer.get()->getBuffer());
+            annotator ann{ counts };
+            annotated += ann.run(mod);
+        }
+    };
+
+    std::unique_ptr< mlir::Pass > createProfileUsePass()
+    {
+        return std::make_unique< ProfileUse >();
+    }
+
+    std::unique_ptr< mlir::Pass > createProfileUsePass(std::string path)
+    {
+        return std::make_unique< ProfileUse >(std::move(path));
+    }
+} // namespace vast::hl
@@ -0,0 +1,224 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#include "vast/Dialect/HighLevel/Passes.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/IR/Builders.h>
+#include <mlir/Interfaces/FunctionInterfaces.h>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/DenseSet.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Util/Common.hpp"
+#include "vast/Util/TypeList.hpp"
+
+#include "vast/Dialect/HighLevel/HighLevelDialect.hpp"
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
+
+#include "PassesDetails.hpp"
+
+namespace vast::hl
+{
+    namespace
+    {
+        bool is_load( operation op )
+        {
+            auto cast = mlir::dyn_cast< hl::ImplicitCastOp >( op );
+            return cast && cast.getKind() == hl::CastKind::LValueToRValue;
+        }
+
+        bool is_volatile( mlir_type type )
+        {
+            using types = util::concat< scalar_types, util::type_list< PointerType > >;
+            return util::dispatch< types, bool >( type, [] ( auto ty ) {
+                return ty.getQuals() && ty.getQuals().hasVolatile();
+            } );
+        }
+
+        // Typedefs and elaborated types are left alone, they would need to be
+        // resolved first.
+        bool is_promotable_type( mlir_type type )
+        {
+            auto scalar = util::is_one_of< scalar_types >( type )
+                || mlir::isa< PointerType >( type );
+            return scalar && !is_volatile( type );
+        }
+
+        // Promotes a variable to SSA values. Every access has to be either a
+        // load or a plain assignment, and assignments have to be placed
+        // directly in the block of the declaration. That way the value of the
+        // variable is known at every operation of the block, and loads nested
+        // in regions of an operation observe the value from before that
+        // operation. Assignments nested in control flow would need the value
+        // yielded out of its regions, which `hl` statements can not do.
+        struct var_promoter
+        {
+            VarDeclOp var;
+            mlir_type type;
+
+            llvm::SmallVector< operation > refs   = {};
+            llvm::SmallVector< operation > loads  = {};
+            llvm::SmallVector< AssignOp > assigns = {};
+
+            static std::optional< var_promoter > get( VarDeclOp var )
+            {
+                if ( !var.hasLocalStorage() || !var.getAllocationSize().empty() )
+                    return std::nullopt;
+
+                auto type = mlir::cast< LValueType >( var.getType() ).getElementType();
+                if ( !is_promotable_type( type ) )
+                    return std::nullopt;
+
+                var_promoter promoter{ var, type };
+                if ( !promoter.collect_uses() )
+                    return std::nullopt;
+                return promoter;
+            }
+
+            bool collect_uses()
+            {
+                auto block = var->getBlock();
+                for ( auto user : var->getUsers() ) {
+                    auto ref = mlir::dyn_cast< DeclRefOp >( user );
+                    if ( !ref )
+                        return false;
+                    refs.push_back( ref );
+
+                    for ( auto &use : ref->getUses() ) {
+                        auto ref_user = use.getOwner();
+                        if ( is_load( ref_user ) ) {
+                            loads.push_back( ref_user );
+                            continue;
+                        }
+
+                        auto assign = mlir::dyn_cast< AssignOp >( ref_user );
+                        if ( !assign || use.getOperandNumber() != 1 )
+                            return false;
+                        if ( assign.getSrc().getType() != type )
+                            return false;
+                        if ( assign->getBlock() != block )
+                            return false;
+                        assigns.push_back( assign );
+                    }
+                }
+                return true;
+            }
+
+            mlir_value initial_value()
+            {
+                auto &init = var.getInitializer();
+                if ( init.empty() )
+                    return {};
+                auto yield = mlir::dyn_cast< ValueYieldOp >( init.back().getTerminator() );
+                if ( !yield || yield.getResult().getType() != type )
+                    return {};
+                return yield.getResult();
+            }
+
+            // Computes values observed by each operation of the declaration
+            // block. Returns false if some load may observe an uninitialized
+            // variable.
+            bool reaching_values( mlir_value init, llvm::DenseMap< operation, mlir_value > &values )
+            {
+                mlir_value current = init;
+                llvm::DenseSet< operation > stores;
+                for ( auto assign : assigns )
+                    stores.insert( assign );
+
+                auto block = var->getBlock();
+                for ( auto &op : llvm::make_range( std::next( var->getIterator() ), block->end() ) ) {
+                    values[ &op ] = current;
+                    if ( stores.contains( &op ) )
+                        current = mlir::cast< AssignOp >( op ).getSrc();
+                }
+
+                return llvm::all_of( loads, [&] ( operation load ) {
+                    auto ancestor = block->findAncestorOpInBlock( *load );
+                    return ancestor && values.lookup( ancestor );
+                } );
+            }
+
+            void inline_initializer()
+            {
+                auto &body = var.getInitializer().front();
+                var->getBlock()->getOperations().splice(
+                    var->getIterator(), body.getOperations(),
+                    body.begin(), body.getTerminator()->getIterator()
+                );
+            }
+
+            bool promote()
+            {
+                auto init = initial_value();
+                if ( !var.getInitializer().empty() && !init )
+                    return false;
+
+                llvm::DenseMap< operation, mlir_value > values;
+                if ( !reaching_values( init, values ) )
+                    return false;
+
+                if ( init )
+                    inline_initializer();
+
+                auto block = var->getBlock();
+                for ( auto load : loads ) {
+                    auto ancestor = block->findAncestorOpInBlock( *load );
+                    load->getResult( 0 ).replaceAllUsesWith( values.lookup( ancestor ) );
+                    load->erase();
+                }
+
+                for ( auto assign : assigns ) {
+                    assign.getResult().replaceAllUsesWith( assign.getSrc() );
+                    assign->erase();
+                }
+
+                for ( auto ref : refs )
+                    ref->erase();
+                var->erase();
+                return true;
+            }
+        };
+
+        bool has_jumps( mlir::FunctionOpInterface fn )
+        {
+            auto result = fn->walk( [] ( operation op ) {
+                if ( mlir::isa< GotoStmt, LabelStmt >( op ) )
+                    return mlir::WalkResult::interrupt();
+                return mlir::WalkResult::advance();
+            } );
+            return result.wasInterrupted();
+        }
+
+    } // namespace
+
+    struct PromoteVars : PromoteVarsBase< PromoteVars >
+    {
+        void promote( mlir::FunctionOpInterface fn )
+        {
+            // Labels make arbitrary parts of a block reachable, the value
+            // at an operation is then not determined by the block order.
+            if ( has_jumps( fn ) )
+                return;
+
+            llvm::SmallVector< VarDeclOp > vars;
+            fn->walk( [&] ( VarDeclOp var ) { vars.push_back( var ); } );
+
+            for ( auto var : vars ) {
+                if ( auto promoter = var_promoter::get( var ) )
+                    promoter->promote();
+            }
+        }
+
+        void runOnOperation() override
+        {
+            getOperation()->walk( [&] ( mlir::FunctionOpInterface fn ) { promote( fn ); } );
+        }
+    };
+
+    std::unique_ptr< mlir::Pass > createPromoteVarsPass()
+    {
+        return std::make_unique< PromoteVars >();
+    }
+} // namespace vast::hl
@@ -0,0 +1,216 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#include "vast/Dialect/HighLevel/Passes.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/IR/AttrTypeSubElements.h>
+
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/TypeSwitch.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Util/Common.hpp"
+
+#include "vast/Dialect/HighLevel/HighLevelDialect.hpp"
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
+
+#include "PassesDetails.hpp"
+
+namespace vast::hl
+{
+    namespace
+    {
+        bool is_discardable( core::GlobalLinkageKind linkage )
+        {
+            using enum core::GlobalLinkageKind;
+            switch ( linkage ) {
+                case InternalLinkage:
+                case PrivateLinkage:
+                case LinkOnceAnyLinkage:
+                case LinkOnceODRLinkage:
+                case AvailableExternallyLinkage:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        // The profiling init function is referenced only by the module
+        // constructor list created when lowering to LLVM.
+        bool is_extern_visible( FuncOp fn )
+        {
+            if ( fn.getSymName() == profile::runtime::init_name )
+                return true;
+            return !fn.isDeclaration() && !is_discardable( fn.getLinkage() );
+        }
+
+        // Tentative definitions of non-static globals are definitions as far
+        // as other translation units are concerned.
+        bool is_extern_visible( VarDeclOp var )
+        {
+            auto storage = var.getStorageClass();
+            if ( storage == StorageClass::sc_static )
+                return false;
+            return storage != StorageClass::sc_extern || !var.getInitializer().empty();
+        }
+
+        // C keeps tags (structures, unions and enums) and ordinary identifiers
+        // (functions, variables, typedefs and enum constants) in separate
+        // namespaces.
+        struct module_symbols
+        {
+            using symbols_t = llvm::StringMap< llvm::SmallVector< operation, 2 > >;
+
+            symbols_t ordinary;
+            symbols_t tags;
+
+            // Top-level operations that may be erased if unreferenced.
+            llvm::SmallVector< operation > removable;
+            llvm::SmallVector< operation > roots;
+
+            void add( operation op )
+            {
+                llvm::TypeSwitch< operation >( op )
+                    .Case< FuncOp >( [&] ( auto fn ) {
+                        ordinary[ fn.getSymName() ].push_back( op );
+                        removable.push_back( op );
+                        if ( is_extern_visible( fn ) )
+                            roots.push_back( op );
+                    } )
+                    .Case< VarDeclOp >( [&] ( auto var ) {
+                        ordinary[ var.getName() ].push_back( op );
+                        removable.push_back( op );
+                        if ( is_extern_visible( var ) )
+                            roots.push_back( op );
+                    } )
+                    .Case< TypeDefOp >( [&] ( auto def ) {
+                        ordinary[ def.getName() ].push_back( op );
+                        removable.push_back( op );
+                    } )
+                    .Case< EnumDeclOp >( [&] ( auto decl ) {
+                        tags[ decl.getName() ].push_back( op );
+                        for ( auto constant : decl.getConstants().template getOps< EnumConstantOp >() )
+                            ordinary[ constant.getName() ].push_back( op );
+                        removable.push_back( op );
+                    } )
+                    .Case< StructDeclOp, UnionDeclOp, TypeDeclOp >( [&] ( auto decl ) {
+                        tags[ decl.getName() ].push_back( op );
+                        removable.push_back( op );
+                    } )
+                    .Default( [&] ( auto ) { roots.push_back( op ); } );
+            }
+        };
+
+        struct reachability
+        {
+            vast_module mod;
+            module_symbols symbols = {};
+
+            llvm::DenseSet< operation > live = {};
+            llvm::SmallVector< operation > worklist = {};
+
+            void mark( operation op )
+            {
+                if ( live.insert( op ).second )
+                    worklist.push_back( op );
+            }
+
+            void mark( const module_symbols::symbols_t &table, llvm::StringRef name )
+            {
+                if ( auto it = table.find( name ); it != table.end() ) {
+                    for ( auto op : it->second )
+                        mark( op );
+                }
+            }
+
+            void mark_type( mlir_type type )
+            {
+                if ( auto record = mlir::dyn_cast< RecordType >( type ) )
+                    mark( symbols.tags, record.getName() );
+                else if ( auto enum_type = mlir::dyn_cast< EnumType >( type ) )
+                    mark( symbols.tags, enum_type.getName() );
+                else if ( auto def = mlir::dyn_cast< TypedefType >( type ) )
+                    mark( symbols.ordinary, def.getName() );
+            }
+
+            void visit( operation root, mlir::AttrTypeWalker &walker )
+            {
+                root->walk( [&] ( operation op ) {
+                    walker.walk( op->getAttrDictionary() );
+                    for ( auto type : op->getResultTypes() )
+                        walker.walk( type );
+                    for ( auto &region : op->getRegions() ) {
+                        for ( auto &block : region ) {
+                            for ( auto arg : block.getArgumentTypes() )
+                                walker.walk( arg );
+                        }
+                    }
+
+                    for ( auto operand : op->getOperands() ) {
+                        auto def = operand.getDefiningOp();
+                        if ( def && def->getParentOp() == mod.getOperation() )
+                            mark( def );
+                    }
+
+                    if ( auto ref = mlir::dyn_cast< GlobalRefOp >( op ) )
+                        mark( symbols.ordinary, ref.getGlobal() );
+                    if ( auto ref = mlir::dyn_cast< EnumRefOp >( op ) )
+                        mark( symbols.ordinary, ref.getValue() );
+                } );
+            }
+
+            void run( const auto &extra_roots )
+            {
+                for ( auto &op : mod.getBody()->getOperations() )
+                    symbols.add( &op );
+
+                for ( auto root : symbols.roots )
+                    mark( root );
+                for ( const auto &name : extra_roots ) {
+                    mark( symbols.ordinary, name );
+                    mark( symbols.tags, name );
+                }
+
+                mlir::AttrTypeWalker walker;
+                walker.addWalk( [&] ( mlir::SymbolRefAttr ref ) {
+                    mark( symbols.ordinary, ref.getRootReference() );
+                } );
+                walker.addWalk( [&] ( mlir_type type ) { mark_type( type ); } );
+
+                while ( !worklist.empty() )
+                    visit( worklist.pop_back_val(), walker );
+            }
+        };
+
+    } // namespace
+
+    struct SymbolDCE : SymbolDCEBase< SymbolDCE >
+    {
+        void runOnOperation() override
+        {
+            auto mod = getOperation();
+
+            reachability reach{ mod };
+            reach.run( roots );
+
+            auto dead = llvm::to_vector( llvm::make_filter_range(
+                reach.symbols.removable, [&] ( operation op ) { return !reach.live.contains( op ); }
+            ) );
+
+            // Dead declarations may still refer to each other.
+            for ( auto op : dead )
+                op->dropAllReferences();
+            for ( auto op : dead )
+                op->erase();
+
+            erased += dead.size();
+        }
+    };
+
+    std::unique_ptr< mlir::Pass > createSymbolDCEPass()
+    {
+        return std::make_unique< SymbolDCE >();
+    }
+} // namespace vast::hl
@@ -24,6 +24,15 @@ namespace vast::ll
         return mlir::SuccessorOperands( getOperandsMutable() );
     }
 
+    logical_result Switch::verify()
+    {
+        auto values = getCaseValues();
+        std::size_t count = values ? values->getNumElements() : 0;
+        if ( count != getCaseDests().size() )
+            return emitOpError( "number of case values does not match number of successors" );
+        return mlir::success();
+    }
+
     // This is currently stolen from HighLevel/HighLevelOps.cpp.
     // Do we need a separate version?
 
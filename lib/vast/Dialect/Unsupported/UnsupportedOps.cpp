@@ -26,7 +26,7 @@ namespace vast::unsup {
 
     void UnsupportedStmt::build(
         Builder &bld, State &st, llvm::StringRef name, Type rty,
-        const std::vector< BuilderCallBackFn > &builders
+        llvm::ArrayRef< BuilderCallBackFn > builders
     ) {
         InsertionGuard guard(bld);
         // Optional, add a check if rty exist.
@@ -3,7 +3,15 @@
 #include "vast/Frontend/Consumer.hpp"
 
 VAST_RELAX_WARNINGS
+#include <clang/Basic/DiagnosticFrontend.h>
+
+#include <llvm/ADT/ScopeExit.h>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/ADT/StringSwitch.h>
+#include <llvm/IR/Module.h>
+#include <llvm/MC/TargetRegistry.h>
 #include <llvm/Support/Signals.h>
+#include <llvm/Target/TargetMachine.h>
 
 #include <mlir/Target/LLVMIR/Dialect/All.h>
 #include <mlir/Target/LLVMIR/LLVMTranslationInterface.h>
@@ -19,6 +27,7 @@ VAST_UNRELAX_WARNINGS
 #include "vast/Util/Common.hpp"
 
 #include "vast/Target/LLVMIR/Convert.hpp"
+#include "vast/Target/LLVMIR/SplitCodeGen.hpp"
 
 namespace vast::cc {
 
@@ -34,6 +43,18 @@ namespace vast::cc {
 
     [[nodiscard]] target_dialect parse_target_dialect(string_ref from);
 
+    [[nodiscard]] unsigned parse_opt_level(const vast_args &vargs, const cc::codegen_options &opts);
+
+    [[nodiscard]] unsigned parse_codegen_partitions(const vast_args &vargs);
+
+    [[nodiscard]] cg::function_selection parse_function_selection(const vast_args &vargs);
+
+    [[nodiscard]] std::optional< ir_profile_format > parse_profile_ir(const vast_args &vargs);
+
+    [[nodiscard]] std::unique_ptr< llvm::TargetMachine > create_target_machine(
+        const std::string &triple, const action_options &opts
+    );
+
     [[nodiscard]] std::string to_string(target_dialect target);
 
     void emit_mlir_output(target_dialect target, owning_module_ref mod, mcontext_t *mctx);
@@ -49,7 +70,18 @@ namespace vast::cc {
             *mctx, actx, get_source_language(opts.lang)
         );
 
-        codegen = std::make_unique< cg::codegen_driver >(*cgctx, opts);
+        cg::codegen_driver_options driver_opts = {
+            .defer_function_bodies = vargs.has_option(opt::defer_function_bodies),
+            .lazy_function_bodies  = vargs.has_option(opt::materialize),
+            .selection             = parse_function_selection(vargs)
+        };
+
+        codegen = std::make_unique< cg::codegen_driver >(*cgctx, opts, std::move(driver_opts));
+
+        if (auto format = parse_profile_ir(vargs)) {
+            pass_profile = std::make_unique< ir_profile >();
+            pass_profile_format = *format;
+        }
     }
 
     bool vast_consumer::HandleTopLevelDecl(clang::DeclGroupRef decls) {
@@ -83,6 +115,18 @@ namespace vast::cc {
         // global codegen, followed by running vast passes.
         codegen->handle_translation_unit(actx);
 
+        // Bodies stay pending and only the listed functions are emitted.
+        if (auto symbols = vargs.get_options_list(opt::materialize)) {
+            for (auto symbol : *symbols) {
+                if (!codegen->materialize(symbol)) {
+                    opts.diags.Report(opts.diags.getCustomDiagID(
+                        clang::DiagnosticsEngine::Warning, "cannot materialize '%0', no such function"
+                    )) << symbol;
+                }
+            }
+            codegen->drop_pending_function_bodies();
+        }
+
         if (!vargs.has_option(opt::disable_vast_verifier)) {
             if (!codegen->verify_module()) {
                 VAST_UNREACHABLE("codegen: module verification error before running vast passes");
@@ -91,6 +135,48 @@ namespace vast::cc {
 
         auto mod  = std::move(cgctx->mod);
 
+        // Same condition as clang uses to decide whether to emit TBAA metadata.
+        if (opts.codegen.OptimizationLevel > 0 && !opts.codegen.RelaxedAliasing) {
+            mod->setAttr(
+                core::CoreDialect::getStrictAliasingAttrName(), mlir::UnitAttr::get(mctx.get())
+            );
+        }
+
+        if (auto opt_level = parse_opt_level(vargs, opts.codegen); opt_level > 0) {
+            mod->setAttr(
+                core::CoreDialect::getOptLevelAttrName(),
+                mlir::IntegerAttr::get(mlir::IntegerType::get(mctx.get(), 32), opt_level)
+            );
+        }
+
+        // Enabled by default whenever optimizations can make use of the markers.
+        auto lifetime_markers = vargs.has_option(opt::emit_lifetime_markers)
+            || (opts.codegen.OptimizationLevel > 0 && !opts.codegen.DisableLifetimeMarkers);
+        if (lifetime_markers) {
+            mod->setAttr(
+                core::CoreDialect::getLifetimeMarkersAttrName(), mlir::UnitAttr::get(mctx.get())
+            );
+        }
+
+        if (vargs.has_option(opt::instrument_profile)) {
+            mod->setAttr(
+                core::CoreDialect::getInstrumentProfileAttrName(), mlir::UnitAttr::get(mctx.get())
+            );
+        }
+
+        if (auto profile = vargs.get_option(opt::profile_use)) {
+            mod->setAttr(
+                core::CoreDialect::getProfileUseAttrName(), mlir::StringAttr::get(mctx.get(), *profile)
+            );
+        }
+
+        // Reported once all pipelines ran, whichever output is emitted.
+        auto report_profile = llvm::make_scope_exit([&] {
+            if (pass_profile) {
+                pass_profile->print(llvm::errs(), pass_profile_format);
+            }
+        });
+
         compile_via_vast(mod.get(), mctx.get());
 
         switch (action) {
@@ -169,17 +255,65 @@ namespace vast::cc {
     ) {
         llvm::LLVMContext llvm_context;
         llvmir::register_vast_to_llvm_ir(*mctx);
+
         auto pipeline = parse_pipeline(vargs.get_options_list(opt::opt_pipeline));
-        llvmir::lower_hl_module(mlir_module.get(), pipeline);
+        llvmir::lower_hl_module(mlir_module.get(), pipeline, [&] (auto &pm) { profile_passes(pm); });
 
         auto mod = llvmir::translate(mlir_module.get(), llvm_context);
         auto dl  = cgctx->actx.getTargetInfo().getDataLayoutString();
+
+        auto partitions = parse_codegen_partitions(vargs);
+        if (partitions > 1 && backend_action == backend::Backend_EmitObj) {
+            llvm::Triple triple(mod->getTargetTriple());
+            if (auto linker = llvmir::find_relocatable_linker(triple)) {
+                return emit_split_object(std::move(mod), dl, partitions, *linker);
+            }
+
+            opts.diags.Report(opts.diags.getCustomDiagID(
+                clang::DiagnosticsEngine::Warning,
+                "no linker found to merge codegen partitions for target '%0', emitting a single partition"
+            )) << triple.str();
+        }
+
         clang::EmitBackendOutput(
             opts.diags, opts.headers, opts.codegen, opts.target, opts.lang, dl, mod.get(),
             backend_action, &opts.vfs, std::move(output_stream)
         );
     }
 
+    // The module is optimized as a whole, only the backend runs per partition,
+    // so that the partitioning does not affect inlining and other IPO.
+    void vast_consumer::emit_split_object(
+        std::unique_ptr< llvm::Module > mod, string_ref data_layout,
+        unsigned partitions, string_ref linker
+    ) {
+        clang::EmitBackendOutput(
+            opts.diags, opts.headers, opts.codegen, opts.target, opts.lang, data_layout,
+            mod.get(), backend::Backend_EmitNothing, &opts.vfs, nullptr
+        );
+
+        auto report = [&] (llvm::Error err) {
+            opts.diags.Report(clang::diag::err_fe_error_backend) << llvm::toString(std::move(err));
+        };
+
+        auto triple = mod->getTargetTriple();
+        auto objects = llvmir::split_codegen(*mod, partitions, [&] {
+            return create_target_machine(triple, opts);
+        });
+        if (!objects) {
+            return report(objects.takeError());
+        }
+
+        auto object = llvmir::link_relocatable(linker, *objects);
+        if (!object) {
+            return report(object.takeError());
+        }
+
+        if (output_stream) {
+            *output_stream << (*object)->getBuffer();
+        }
+    }
+
     void vast_consumer::emit_mlir_output(
         target_dialect target, owning_module_ref mod, mcontext_t *mctx
     ) {
@@ -194,7 +328,9 @@ namespace vast::cc {
                 case target_dialect::llvm: {
                     // TODO: These should probably be moved outside of `target::llvmir`.
                     llvmir::register_vast_to_llvm_ir(*mctx);
-                    llvmir::lower_hl_module(mod.get());
+                    llvmir::lower_hl_module(
+                        mod.get(), llvmir::default_pipeline(), [&] (auto &pm) { profile_passes(pm); }
+                    );
                     break;
                 }
                 default:
@@ -244,12 +380,20 @@ namespace vast::cc {
 
     void vast_consumer::compile_via_vast(vast_module mod, mcontext_t *mctx) {
         const bool enable_vast_verifier = !vargs.has_option(opt::disable_vast_verifier);
-        auto pass = cg::emit_high_level_pass(mod, mctx, &cgctx->actx, enable_vast_verifier);
+        auto pass = cg::emit_high_level_pass(
+            mod, mctx, &cgctx->actx, enable_vast_verifier, [&] (auto &pm) { profile_passes(pm); }
+        );
         if (pass.failed()) {
             VAST_UNREACHABLE("codegen: MLIR pass manager fails when running vast passes");
         }
     }
 
+    void vast_consumer::profile_passes(mlir::PassManager &pm) {
+        if (pass_profile) {
+            pass_profile->attach(pm);
+        }
+    }
+
     source_language get_source_language(const cc::language_options &opts) {
         using ClangStd = clang::LangStandard;
 
@@ -294,6 +438,9 @@ namespace vast::cc {
         if (trg == "with-abi") {
             return pipeline::with_abi;
         }
+        if (trg == "with-scf") {
+            return pipeline::with_scf;
+        }
         if (trg == "baseline") {
             return pipeline::baseline;
         }
@@ -301,6 +448,112 @@ namespace vast::cc {
         VAST_UNREACHABLE("Unknown option of pipeline to use: {0}", trg);
     }
 
+    // MLIR optimizations follow the clang optimization level, unless the
+    // level is given explicitly by `-vast-opt-level=N`.
+    unsigned parse_opt_level(const vast_args &vargs, const cc::codegen_options &opts) {
+        auto level = vargs.get_option(opt::opt_level);
+        if (!level) {
+            return opts.OptimizationLevel;
+        }
+
+        unsigned result = 0;
+        if (level->getAsInteger(10, result)) {
+            VAST_UNREACHABLE("Invalid optimization level: {0}", level.value());
+        }
+
+        return result;
+    }
+
+    unsigned parse_codegen_partitions(const vast_args &vargs) {
+        auto partitions = vargs.get_option(opt::codegen_partitions);
+        if (!partitions) {
+            return 1;
+        }
+
+        unsigned result = 0;
+        if (partitions->getAsInteger(10, result) || result == 0) {
+            VAST_UNREACHABLE("Invalid number of codegen partitions: {0}", partitions.value());
+        }
+
+        return result;
+    }
+
+    // `-vast-profile-ir` prints a table, `-vast-profile-ir=json` a JSON array.
+    std::optional< ir_profile_format > parse_profile_ir(const vast_args &vargs) {
+        if (!vargs.has_option(opt::profile_ir)) {
+            return std::nullopt;
+        }
+
+        auto format = vargs.get_option(opt::profile_ir);
+        if (!format) {
+            return ir_profile_format::table;
+        }
+
+        if (auto parsed = parse_ir_profile_format(*format)) {
+            return parsed;
+        }
+
+        VAST_UNREACHABLE("Unknown format of IR profile: {0}", format.value());
+    }
+
+    // Patterns of `-vast-emit-only` are regular expressions matched against
+    // whole mangled names, `-vast-reachable-from` lists plain symbols. Invalid
+    // patterns are diagnosed by the codegen driver.
+    cg::function_selection parse_function_selection(const vast_args &vargs) {
+        cg::function_selection selection;
+
+        for (auto pattern : vargs.get_options_list(opt::emit_only).value_or(vast_args::option_list{})) {
+            selection.patterns.push_back(pattern.str());
+        }
+
+        for (auto root : vargs.get_options_list(opt::reachable_from).value_or(vast_args::option_list{})) {
+            selection.roots.push_back(root.str());
+        }
+
+        return selection;
+    }
+
+    // Mirrors the subset of clang's target machine setup that affects the
+    // emitted code of partitions.
+    std::unique_ptr< llvm::TargetMachine > create_target_machine(
+        const std::string &triple, const action_options &opts
+    ) {
+        std::string error;
+        auto target = llvm::TargetRegistry::lookupTarget(triple, error);
+        if (!target) {
+            return nullptr;
+        }
+
+        llvm::TargetOptions options;
+        options.FunctionSections   = opts.codegen.FunctionSections;
+        options.DataSections       = opts.codegen.DataSections;
+        options.UniqueSectionNames = opts.codegen.UniqueSectionNames;
+
+        auto code_model = llvm::StringSwitch< std::optional< llvm::CodeModel::Model > >(
+            opts.codegen.CodeModel
+        )
+            .Case("tiny", llvm::CodeModel::Tiny)
+            .Case("small", llvm::CodeModel::Small)
+            .Case("kernel", llvm::CodeModel::Kernel)
+            .Case("medium", llvm::CodeModel::Medium)
+            .Case("large", llvm::CodeModel::Large)
+            .Default(std::nullopt);
+
+        auto level = [&] {
+            switch (opts.codegen.OptimizationLevel) {
+                case 0:  return llvm::CodeGenOpt::None;
+                case 1:  return llvm::CodeGenOpt::Less;
+                case 2:  return llvm::CodeGenOpt::Default;
+                default: return llvm::CodeGenOpt::Aggressive;
+            }
+        }();
+
+        return std::unique_ptr< llvm::TargetMachine >(target->createTargetMachine(
+            triple, opts.target.CPU, llvm::join(opts.target.Features, ","), options,
+            opts.codegen.RelocationModel, code_model, level
+        ));
+    }
+
     target_dialect parse_target_dialect(string_ref from) {
         auto trg = from.lower();
         if (trg == "hl" || trg == "high_level") {
@@ -33,27 +33,66 @@ namespace vast::target::llvmir
     namespace
     {
         // TODO(target): Unify with tower and opt.
-        void populate_pm(mlir::PassManager &pm, pipeline p)
-        {
+        //
+        // Each stage (hl, ll and llvm) is followed by its optimization
+        // pipeline, which is empty at `opt_level` 0. Profile counters are
+        // inserted and profiles are read before any optimization, so that
+        // both follow the source.
+        void populate_pm(
+            mlir::PassManager &pm, pipeline p, unsigned opt_level,
+            bool lifetime_markers, bool instrument_profile, llvm::StringRef profile_use
+        ) {
+            if (instrument_profile)
+                pm.addPass(hl::createInstrumentProfilePass());
+            if (!profile_use.empty())
+                pm.addPass(hl::createProfileUsePass(profile_use.str()));
+
+            hl::build_optimize_hl_pipeline(pm, opt_level);
+
             switch (p)
             {
                 case pipeline::baseline:
                 {
                     hl::build_simplify_hl_pipeline(pm);
-                    build_to_ll_pipeline(pm);
+                    build_to_ll_pipeline(pm, lifetime_markers);
+                    build_optimize_ll_pipeline(pm, opt_level);
                     build_to_llvm_pipeline(pm);
-                    return;
+                    break;
                 }
                 case pipeline::with_abi:
                 {
                     hl::build_simplify_hl_pipeline(pm);
                     build_abi_pipeline(pm);
-                    build_to_ll_pipeline(pm);
+                    build_to_ll_pipeline(pm, lifetime_markers);
+                    build_optimize_ll_pipeline(pm, opt_level);
+                    build_to_llvm_pipeline(pm);
+                    break;
+                }
+                case pipeline::with_scf:
+                {
+                    hl::build_simplify_hl_pipeline(pm);
+                    build_scf_pipeline(pm, opt_level);
+                    build_to_ll_pipeline(pm, lifetime_markers);
+                    build_optimize_ll_pipeline(pm, opt_level);
                     build_to_llvm_pipeline(pm);
-                    return;
+                    build_scf_to_llvm_pipeline(pm);
+                    break;
                 }
             }
 
+            build_optimize_llvm_pipeline(pm, opt_level);
+        }
+
+        unsigned get_opt_level(mlir::Operation *op)
+        {
+            auto attr = op->getAttrOfType< mlir::IntegerAttr >(core::CoreDialect::getOptLevelAttrName());
+            return attr ? static_cast< unsigned >(attr.getInt()) : 0;
+        }
+
+        llvm::StringRef get_profile_use(mlir::Operation *op)
+        {
+            auto attr = op->getAttrOfType< mlir::StringAttr >(core::CoreDialect::getProfileUseAttrName());
+            return attr ? attr.getValue() : llvm::StringRef();
         }
     } // namespace
 
@@ -119,10 +158,20 @@ namespace vast::target::llvmir
     }
 
     void lower_hl_module(mlir::Operation *op, pipeline p)
+    {
+        lower_hl_module(op, p, [] (mlir::PassManager &) {});
+    }
+
+    void lower_hl_module(mlir::Operation *op, pipeline p, pass_manager_hook hook)
     {
         auto mctx = op->getContext();
         mlir::PassManager pm(mctx);
-        populate_pm(pm, p);
+        populate_pm(pm, p,
+            get_opt_level(op),
+            op->hasAttr(core::CoreDialect::getLifetimeMarkersAttrName()),
+            op->hasAttr(core::CoreDialect::getInstrumentProfileAttrName()),
+            get_profile_use(op)
+        );
 
         // This is necessary to have line tables emitted and basic
         // debugger working. In the future we will add proper debug information
@@ -138,6 +187,7 @@ namespace vast::target::llvmir
                             true, // after failure
                             llvm::errs());
 
+        hook(pm);
 
         auto run_result = pm.run(op);
 
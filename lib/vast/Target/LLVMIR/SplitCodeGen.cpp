@@ -0,0 +1,175 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#include "vast/Target/LLVMIR/SplitCodeGen.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/ScopeExit.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/FormatVariadic.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/SmallVectorMemoryBuffer.h>
+#include <llvm/Support/ThreadPool.h>
+#include <llvm/Support/Threading.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/TargetParser/Host.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
+VAST_UNRELAX_WARNINGS
+
+namespace vast::target::llvmir
+{
+    namespace
+    {
+        llvm::Error make_error(const llvm::Twine &msg)
+        {
+            return llvm::createStringError(llvm::inconvertibleErrorCode(), msg);
+        }
+
+        // Partitions share no state with each other, each one is parsed into
+        // its own context and compiled by its own target machine.
+        llvm::Expected< object_buffer > compile_partition(
+            llvm::StringRef bitcode, unsigned idx, const target_machine_factory &make_target_machine
+        ) {
+            auto name = llvm::formatv("partition-{0}.o", idx).str();
+
+            llvm::LLVMContext ctx;
+            auto mod = llvm::parseBitcodeFile(llvm::MemoryBufferRef(bitcode, name), ctx);
+            if (!mod)
+                return mod.takeError();
+
+            auto tm = make_target_machine();
+            if (!tm)
+                return make_error("cannot create target machine");
+
+            llvm::SmallVector< char, 0 > object;
+            llvm::raw_svector_ostream os(object);
+
+            llvm::legacy::PassManager pm;
+            if (tm->addPassesToEmitFile(pm, os, nullptr, llvm::CGFT_ObjectFile))
+                return make_error("target does not support object file emission");
+            pm.run(**mod);
+
+            return std::make_unique< llvm::SmallVectorMemoryBuffer >(
+                std::move(object), name, /* RequiresNullTerminator */ false
+            );
+        }
+
+    } // namespace
+
+    llvm::Expected< std::vector< object_buffer > > split_codegen(
+        llvm::Module &mod, unsigned partitions, const target_machine_factory &make_target_machine
+    ) {
+        // Partitions are serialized to break their ties to the context of `mod`.
+        // Local symbols stay in the partition of their users. Externalizing
+        // them would turn every `static` of the translation unit into a global
+        // symbol of the linked object, which clashes with other objects.
+        std::vector< llvm::SmallVector< char, 0 > > bitcode;
+        llvm::SplitModule(mod, partitions, [&] (std::unique_ptr< llvm::Module > part) {
+            llvm::raw_svector_ostream os(bitcode.emplace_back());
+            llvm::WriteBitcodeToFile(*part, os);
+        }, /* PreserveLocals */ true);
+
+        std::vector< object_buffer > objects(bitcode.size());
+        std::vector< std::string > errors(bitcode.size());
+
+        llvm::ThreadPool pool(llvm::hardware_concurrency(bitcode.size()));
+        for (unsigned idx = 0; idx < bitcode.size(); ++idx) {
+            pool.async([&, idx] {
+                llvm::StringRef buffer(bitcode[idx].data(), bitcode[idx].size());
+                if (auto object = compile_partition(buffer, idx, make_target_machine))
+                    objects[idx] = std::move(*object);
+                else
+                    errors[idx] = llvm::toString(object.takeError());
+            });
+        }
+        pool.wait();
+
+        // Report the first failure in the partition order to stay deterministic.
+        for (const auto &[idx, error] : llvm::enumerate(errors)) {
+            if (!error.empty())
+                return make_error(llvm::formatv("partition {0}: {1}", idx, error));
+        }
+
+        return objects;
+    }
+
+    std::optional< std::string > find_relocatable_linker(const llvm::Triple &target)
+    {
+        // lld handles ELF objects of any architecture.
+        if (target.isOSBinFormatELF()) {
+            if (auto path = llvm::sys::findProgramByName("ld.lld"))
+                return *path;
+        }
+
+        // The system linker understands only objects of the host.
+        llvm::Triple host(llvm::sys::getProcessTriple());
+        auto native = target.getArch() == host.getArch()
+            && target.getOS() == host.getOS()
+            && target.getObjectFormat() == host.getObjectFormat();
+
+        if (native) {
+            if (auto path = llvm::sys::findProgramByName("ld"))
+                return *path;
+        }
+
+        return std::nullopt;
+    }
+
+    llvm::Expected< object_buffer > link_relocatable(
+        llvm::StringRef linker, llvm::ArrayRef< object_buffer > objects
+    ) {
+        std::vector< std::string > temporaries;
+        auto cleanup = llvm::make_scope_exit([&] {
+            for (const auto &path : temporaries)
+                llvm::sys::fs::remove(path);
+        });
+
+        auto make_temporary = [&] (llvm::StringRef prefix) -> llvm::Expected< std::string > {
+            llvm::SmallString< 128 > path;
+            if (auto ec = llvm::sys::fs::createTemporaryFile(prefix, "o", path))
+                return llvm::errorCodeToError(ec);
+            return temporaries.emplace_back(path.str());
+        };
+
+        std::vector< std::string > inputs;
+        for (const auto &object : objects) {
+            auto path = make_temporary("vast-partition");
+            if (!path)
+                return path.takeError();
+
+            std::error_code ec;
+            llvm::raw_fd_ostream os(*path, ec);
+            if (ec)
+                return llvm::errorCodeToError(ec);
+            os << object->getBuffer();
+            os.close();
+            if (os.has_error())
+                return llvm::errorCodeToError(os.error());
+
+            inputs.push_back(std::move(*path));
+        }
+
+        auto output = make_temporary("vast-linked");
+        if (!output)
+            return output.takeError();
+
+        llvm::SmallVector< llvm::StringRef > args = { linker, "-r", "-o", *output };
+        args.append(inputs.begin(), inputs.end());
+
+        std::string message;
+        if (llvm::sys::ExecuteAndWait(linker, args, std::nullopt, {}, 0, 0, &message) != 0)
+            return make_error(llvm::formatv("relocatable link failed: {0}", message));
+
+        auto linked = llvm::MemoryBuffer::getFile(*output);
+        if (!linked)
+            return llvm::errorCodeToError(linked.getError());
+        return std::move(*linked);
+    }
+
+} // namespace vast::target::llvmir
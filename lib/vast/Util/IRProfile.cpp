@@ -0,0 +1,292 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#include "vast/Util/IRProfile.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/StringSet.h>
+#include <llvm/Support/FormatVariadic.h>
+#include <llvm/Support/JSON.h>
+
+#include <mlir/IR/AttrTypeSubElements.h>
+#include <mlir/Pass/PassInstrumentation.h>
+#include <mlir/Pass/PassManager.h>
+VAST_UNRELAX_WARNINGS
+
+#include <chrono>
+#include <cstdlib>
+
+namespace vast {
+
+    ir_stats ir_stats::collect(operation root) {
+        ir_stats stats;
+
+        llvm::DenseSet< mlir::Attribute > attrs;
+        llvm::DenseSet< mlir::Type > types;
+
+        mlir::AttrTypeWalker walker;
+        walker.addWalk([&] (mlir::Attribute attr) { attrs.insert(attr); });
+        walker.addWalk([&] (mlir::Type type) { types.insert(type); });
+
+        root->walk([&] (operation op) {
+            auto name = op->getName();
+            ++stats.ops[name.getStringRef()];
+            ++stats.dialects[name.getDialectNamespace()];
+
+            walker.walk(op->getAttrDictionary());
+            walker.walk(mlir::LocationAttr(op->getLoc()));
+            for (auto type : op->getResultTypes()) {
+                walker.walk(type);
+            }
+
+            stats.regions += op->getNumRegions();
+            for (auto &region : op->getRegions()) {
+                for (auto &block : region) {
+                    ++stats.blocks;
+                    for (auto arg : block.getArguments()) {
+                        walker.walk(arg.getType());
+                    }
+                }
+            }
+        });
+
+        stats.attributes = attrs.size();
+        stats.types      = types.size();
+        return stats;
+    }
+
+    std::size_t ir_stats::total_ops() const {
+        std::size_t total = 0;
+        for (const auto &entry : ops) {
+            total += entry.getValue();
+        }
+        return total;
+    }
+
+    ir_stats &ir_stats::operator+=(const ir_stats &other) {
+        for (const auto &entry : other.ops) {
+            ops[entry.getKey()] += entry.getValue();
+        }
+        for (const auto &entry : other.dialects) {
+            dialects[entry.getKey()] += entry.getValue();
+        }
+        blocks     += other.blocks;
+        regions    += other.regions;
+        attributes += other.attributes;
+        types      += other.types;
+        return *this;
+    }
+
+    std::optional< ir_profile_format > parse_ir_profile_format(string_ref format) {
+        if (format == "table") {
+            return ir_profile_format::table;
+        }
+        if (format == "json") {
+            return ir_profile_format::json;
+        }
+        return std::nullopt;
+    }
+
+    namespace {
+
+        // Pass adaptors running nested pipelines have no argument, their time
+        // and IR changes are attributed to the nested passes.
+        bool is_profiled(mlir::Pass *pass) { return !pass->getArgument().empty(); }
+
+        struct ir_profile_instrumentation final : mlir::PassInstrumentation {
+            using clock = std::chrono::steady_clock;
+
+            struct running_pass {
+                ir_stats before;
+                clock::time_point start;
+            };
+
+            explicit ir_profile_instrumentation(ir_profile &profile) : profile(profile) {}
+
+            // Statistics are collected outside of the measured time. Passes on
+            // sibling operations may run in parallel, each of them owns the
+            // operation it runs on.
+            void runBeforePass(mlir::Pass *pass, operation op) override {
+                if (!is_profiled(pass)) {
+                    return;
+                }
+
+                auto before = ir_stats::collect(op);
+                std::lock_guard< std::mutex > lock(mutex);
+                running[{ pass, op }] = { std::move(before), clock::now() };
+            }
+
+            void runAfterPass(mlir::Pass *pass, operation op) override { finish(pass, op); }
+            void runAfterPassFailed(mlir::Pass *pass, operation op) override { finish(pass, op); }
+
+            void finish(mlir::Pass *pass, operation op) {
+                if (!is_profiled(pass)) {
+                    return;
+                }
+
+                auto end = clock::now();
+
+                running_pass run;
+                {
+                    std::lock_guard< std::mutex > lock(mutex);
+                    auto it = running.find({ pass, op });
+                    VAST_CHECK(it != running.end(), "missing start of pass {0}", pass->getArgument());
+                    run = std::move(it->second);
+                    running.erase(it);
+                }
+
+                std::chrono::duration< double > elapsed = end - run.start;
+                profile.record(pass->getArgument(), run.before, ir_stats::collect(op), elapsed.count());
+            }
+
+            ir_profile &profile;
+
+            std::mutex mutex;
+            llvm::DenseMap< std::pair< mlir::Pass *, operation >, running_pass > running;
+        };
+
+        std::vector< llvm::StringRef > sorted_keys(const llvm::StringMap< std::size_t > &map) {
+            std::vector< llvm::StringRef > keys;
+            for (const auto &entry : map) {
+                keys.push_back(entry.getKey());
+            }
+            llvm::sort(keys);
+            return keys;
+        }
+
+        std::size_t count_of(const llvm::StringMap< std::size_t > &map, llvm::StringRef key) {
+            auto it = map.find(key);
+            return it == map.end() ? 0 : it->getValue();
+        }
+
+        std::string growth(std::size_t before, std::size_t after) {
+            auto delta = static_cast< std::int64_t >(after) - static_cast< std::int64_t >(before);
+            return llvm::formatv("{0} ({1}{2})", after, delta < 0 ? "" : "+", delta).str();
+        }
+
+        void print_stats(llvm::json::OStream &json, const ir_stats &stats) {
+            json.object([&] {
+                json.attribute("ops", stats.total_ops());
+                json.attribute("blocks", stats.blocks);
+                json.attribute("regions", stats.regions);
+                json.attribute("attributes", stats.attributes);
+                json.attribute("types", stats.types);
+
+                auto print_counts = [&] (llvm::StringRef name, const llvm::StringMap< std::size_t > &map) {
+                    json.attributeObject(name, [&] {
+                        for (auto key : sorted_keys(map)) {
+                            json.attribute(key, count_of(map, key));
+                        }
+                    });
+                };
+
+                print_counts("dialects", stats.dialects);
+                print_counts("op_names", stats.ops);
+            });
+        }
+
+    } // namespace
+
+    void ir_profile::attach(mlir::PassManager &pm) {
+        pm.addInstrumentation(std::make_unique< ir_profile_instrumentation >(*this));
+    }
+
+    void ir_profile::record(
+        string_ref pass, const ir_stats &before, const ir_stats &after, double seconds
+    ) {
+        std::lock_guard< std::mutex > lock(mutex);
+        auto &entry = profiles[pass.str()];
+        ++entry.runs;
+        entry.seconds += seconds;
+        entry.before  += before;
+        entry.after   += after;
+    }
+
+    void ir_profile::print(llvm::raw_ostream &os, ir_profile_format format) const {
+        switch (format) {
+            case ir_profile_format::table: return print_table(os);
+            case ir_profile_format::json:  return print_json(os);
+        }
+    }
+
+    void ir_profile::print_table(llvm::raw_ostream &os) const {
+        std::lock_guard< std::mutex > lock(mutex);
+
+        constexpr const char *row = "{0,-44} {1,5} {2,10} {3,18} {4,16} {5,16} {6,16} {7,16}\n";
+        os << llvm::formatv(row, "pass", "runs", "time [s]", "ops", "blocks", "regions", "attributes", "types");
+
+        for (const auto &[pass, profile] : profiles) {
+            const auto &[runs, seconds, before, after] = profile;
+            os << llvm::formatv(row, pass, runs, llvm::formatv("{0:f4}", seconds).str(),
+                growth(before.total_ops(), after.total_ops()),
+                growth(before.blocks, after.blocks),
+                growth(before.regions, after.regions),
+                growth(before.attributes, after.attributes),
+                growth(before.types, after.types)
+            );
+        }
+
+        // The op kinds each pass changed the most, to see what inflates the IR.
+        constexpr std::size_t top_ops = 5;
+        for (const auto &[pass, profile] : profiles) {
+            using change = std::pair< llvm::StringRef, std::int64_t >;
+            std::vector< change > changes;
+
+            llvm::StringSet<> seen;
+            for (const auto *ops : { &profile.after.ops, &profile.before.ops }) {
+                for (const auto &entry : *ops) {
+                    auto name = entry.getKey();
+                    if (!seen.insert(name).second) {
+                        continue;
+                    }
+
+                    auto delta = static_cast< std::int64_t >(count_of(profile.after.ops, name))
+                               - static_cast< std::int64_t >(count_of(profile.before.ops, name));
+                    if (delta != 0) {
+                        changes.emplace_back(name, delta);
+                    }
+                }
+            }
+
+            if (changes.empty()) {
+                continue;
+            }
+
+            llvm::sort(changes, [] (const change &lhs, const change &rhs) {
+                return std::abs(lhs.second) != std::abs(rhs.second)
+                    ? std::abs(lhs.second) > std::abs(rhs.second)
+                    : lhs.first < rhs.first;
+            });
+
+            os << "\n" << pass << ":\n";
+            for (auto name : llvm::make_first_range(llvm::ArrayRef(changes).take_front(top_ops))) {
+                os << llvm::formatv("    {0,-40} {1}\n", name,
+                    growth(count_of(profile.before.ops, name), count_of(profile.after.ops, name))
+                );
+            }
+        }
+    }
+
+    void ir_profile::print_json(llvm::raw_ostream &os) const {
+        std::lock_guard< std::mutex > lock(mutex);
+
+        llvm::json::OStream json(os, 2);
+        json.array([&] {
+            for (const auto &[pass, profile] : profiles) {
+                json.object([&] {
+                    json.attribute("pass", pass);
+                    json.attribute("runs", profile.runs);
+                    json.attribute("seconds", profile.seconds);
+                    json.attributeBegin("before");
+                    print_stats(json, profile.before);
+                    json.attributeEnd();
+                    json.attributeBegin("after");
+                    print_stats(json, profile.after);
+                    json.attributeEnd();
+                });
+            }
+        });
+        os << "\n";
+    }
+
+} // namespace vast
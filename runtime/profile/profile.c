@@ -0,0 +1,78 @@
+/* Copyright (c) 2023-present, Trail of Bits, Inc. */
+
+#include "profile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Counter arrays are registered by a constructor of each instrumented module,
+ * increments are inlined into the instrumented code. Registered modules form
+ * a lock-free list, only pushed to and never popped.
+ */
+typedef struct module_profile {
+    uint64_t *counters;
+    const char *keys;
+    uint32_t count;
+    struct module_profile *next;
+} module_profile;
+
+static module_profile *modules = NULL;
+static int dump_at_exit_installed = 0;
+
+static void dump_at_exit(void) { __vast_prof_dump(NULL); }
+
+void __vast_prof_register(uint64_t *counters, const char *keys, uint32_t count) {
+    module_profile *module = malloc(sizeof(module_profile));
+    if (!module) {
+        return;
+    }
+
+    module->counters = counters;
+    module->keys     = keys;
+    module->count    = count;
+    module->next     = __atomic_load_n(&modules, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(
+        &modules, &module->next, module, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED
+    )) {}
+
+    if (!__atomic_exchange_n(&dump_at_exit_installed, 1, __ATOMIC_ACQ_REL)) {
+        atexit(dump_at_exit);
+    }
+}
+
+static void dump_module(FILE *out, const module_profile *module) {
+    const char *key = module->keys;
+    for (uint32_t idx = 0; idx < module->count && *key; ++idx) {
+        const char *end = strchr(key, '\n');
+        if (!end) {
+            break;
+        }
+
+        uint64_t count = __atomic_load_n(&module->counters[idx], __ATOMIC_RELAXED);
+        fprintf(out, "%.*s\t%llu\n", (int) (end - key), key, (unsigned long long) count);
+        key = end + 1;
+    }
+}
+
+int __vast_prof_dump(const char *path) {
+    if (!path) {
+        path = getenv("VAST_PROFILE_FILE");
+    }
+    if (!path || !*path) {
+        path = "default.vastprof";
+    }
+
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        return -1;
+    }
+
+    const module_profile *module = __atomic_load_n(&modules, __ATOMIC_ACQUIRE);
+    for (; module; module = module->next) {
+        dump_module(out, module);
+    }
+
+    return fclose(out) == 0 ? 0 : -1;
+}
@@ -0,0 +1,33 @@
+/* Copyright (c) 2023-present, Trail of Bits, Inc. */
+
+#ifndef VAST_RUNTIME_PROFILE_H
+#define VAST_RUNTIME_PROFILE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VAST_PROFILE_API __attribute__((visibility("default")))
+
+/*
+ * Called once by a constructor of each module instrumented with
+ * `vast-hl-instrument-profile`. `counters` is the counter array of the module,
+ * incremented inline by the instrumented code, `keys` holds one newline
+ * terminated key per each of its `count` counters.
+ */
+VAST_PROFILE_API void __vast_prof_register(uint64_t *counters, const char *keys, uint32_t count);
+
+/*
+ * Writes `key<TAB>count` lines of all counters seen so far to `path`. If
+ * `path` is null, `VAST_PROFILE_FILE` or `default.vastprof` is used. The
+ * dump is also written at exit. Returns zero on success.
+ */
+VAST_PROFILE_API int __vast_prof_dump(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VAST_RUNTIME_PROFILE_H */
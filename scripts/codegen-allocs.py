@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+# Copyright (c) 2023-present, Trail of Bits, Inc.
+
+"""
+Counts heap allocations of vast codegen over a generated C file.
+
+The file consists of many functions with nested control flow, so that most
+of the time is spent in region builders of the codegen. Allocations are
+counted by valgrind, compare two builds by passing `--baseline` and keep
+the numbers by passing `--output`:
+
+    scripts/codegen-allocs.py builds/new/tools/vast-front/Release/vast-front \\
+        --baseline builds/old/tools/vast-front/Release/vast-front \\
+        --output codegen-allocs.json
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+HEAP_USAGE = re.compile(r"total heap usage: ([\d,]+) allocs, [\d,]+ frees, ([\d,]+) bytes allocated")
+
+FUNCTION = """
+int fn_{idx}(int a, int b) {{
+    int acc = 0;
+    for (int i = 0; i < a; ++i) {{
+        if (i % 3 == 0)
+            acc += b > i ? b - i : i - b;
+        else if (i % 3 == 1)
+            acc -= (a && b) || i ? 1 : 2;
+        while (acc > 100) {{
+            acc /= 2;
+        }}
+        switch (i & 3) {{
+            case 0: acc ^= a; break;
+            case 1: acc |= b; break;
+            default: acc += sizeof(acc);
+        }}
+    }}
+    do {{
+        acc--;
+    }} while (acc > {idx});
+    return acc;
+}}
+"""
+
+
+def generate(path, functions):
+    with open(path, "w") as out:
+        for idx in range(functions):
+            out.write(FUNCTION.format(idx=idx))
+
+
+def count_allocations(vast_front, source):
+    cmd = [
+        "valgrind", "--tool=memcheck", "--leak-check=no",
+        vast_front, "-cc1", "-vast-emit-mlir=hl", source, "-o", os.devnull,
+    ]
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.exit(f"{vast_front} failed:\n{result.stderr}")
+
+    match = HEAP_USAGE.search(result.stderr)
+    if not match:
+        sys.exit("cannot find heap usage summary in valgrind output")
+
+    allocs, size = (int(group.replace(",", "")) for group in match.groups())
+    return allocs, size
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("vast_front", help="vast-front binary to measure")
+    parser.add_argument("--baseline", help="vast-front binary to compare against")
+    parser.add_argument("--functions", type=int, default=2000, help="number of generated functions")
+    parser.add_argument("--output", help="file to write the JSON results to")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmp:
+        source = os.path.join(tmp, "codegen-allocs.c")
+        generate(source, args.functions)
+
+        results = {"functions": args.functions}
+
+        allocs, size = count_allocations(args.vast_front, source)
+        results["current"] = {"binary": args.vast_front, "allocs": allocs, "bytes": size}
+        print(f"{args.vast_front}: {allocs} allocations, {size} bytes")
+
+        if args.baseline:
+            base_allocs, base_size = count_allocations(args.baseline, source)
+            results["baseline"] = {"binary": args.baseline, "allocs": base_allocs, "bytes": base_size}
+            print(f"{args.baseline}: {base_allocs} allocations, {base_size} bytes")
+            print(f"difference: {allocs - base_allocs:+} allocations, {size - base_size:+} bytes")
+
+    if args.output:
+        with open(args.output, "w") as out:
+            json.dump(results, out, indent=2)
+
+if __name__ == "__main__":
+    main()
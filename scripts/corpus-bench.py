@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+# Copyright (c) 2023-present, Trail of Bits, Inc.
+
+"""
+Compiles a fixed corpus of C files by vast-front and records, per file and
+compilation stage, the wall time, peak RSS and the size of the stage output.
+
+Stages are measured cumulatively, vast-front is stopped after each of them
+and the time of a stage is the difference to the previous one:
+
+    parse      -fsyntax-only
+    hl         -vast-emit-mlir=hl
+    llvm       -vast-emit-mlir=llvm, the whole lowering pipeline
+    translate  -vast-emit-llvm
+    backend    -vast-emit-obj
+
+The size of MLIR stages is the number of operations, of `translate` the
+number of LLVM IR instructions and of `backend` the object file size.
+The corpus defaults to `scripts/corpus` and `test/vast/Compile`. Record a
+baseline and compare a later build against it:
+
+    scripts/corpus-bench.py builds/old/tools/vast-front/Release/vast-front \\
+        --output baseline.json
+    scripts/corpus-bench.py builds/new/tools/vast-front/Release/vast-front \\
+        --baseline baseline.json --threshold 10
+
+The comparison exits with a nonzero status if any metric regressed by more
+than the threshold.
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_CORPUS = [
+    os.path.join(SCRIPT_DIR, "corpus"),
+    os.path.join(SCRIPT_DIR, os.pardir, "test", "vast", "Compile"),
+]
+
+STAGES = [
+    ("parse",     ["-fsyntax-only"], None),
+    ("hl",        ["-vast-emit-mlir=hl"], "mlir"),
+    ("llvm",      ["-vast-emit-mlir=llvm"], "mlir"),
+    ("translate", ["-vast-emit-llvm"], "ll"),
+    ("backend",   ["-vast-emit-obj"], "obj"),
+]
+
+# Operation names in both the custom (`hl.var`) and the generic (`"hl.var"`)
+# form, optionally preceded by results.
+MLIR_OPERATION = re.compile(r'^\s*(?:%[^=]*=\s*)?"?[A-Za-z_][\w$]*\.[\w$.]+')
+LLVM_INSTRUCTION = re.compile(r"^\s+(?:%[\w.]+\s*=\s*)?[a-z]")
+
+# Deltas below these are noise regardless of the relative change.
+MIN_SECONDS = 0.005
+MIN_RSS_KB = 1024
+
+
+def count_size(kind, path):
+    if kind == "obj":
+        return os.path.getsize(path)
+
+    pattern = MLIR_OPERATION if kind == "mlir" else LLVM_INSTRUCTION
+    with open(path, errors="replace") as out:
+        return sum(1 for line in out if pattern.match(line))
+
+
+def run(cmd):
+    start = time.perf_counter()
+    proc = subprocess.Popen(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+    stderr = proc.stderr.read()
+    _, status, usage = os.wait4(proc.pid, 0)
+    elapsed = time.perf_counter() - start
+    proc.returncode = os.waitstatus_to_exitcode(status)
+    proc.stderr.close()
+    # On Linux `ru_maxrss` is in kilobytes and covers reaped subprocesses.
+    return proc.returncode, stderr, elapsed, usage.ru_maxrss
+
+
+def measure_file(vast_front, source, tmp, repetitions, extra_args):
+    results = {}
+    previous = 0.0
+    for stage, flags, kind in STAGES:
+        output = os.path.join(tmp, f"{stage}.out")
+        cmd = [vast_front, "-c", *flags, *extra_args, source, "-o", output]
+
+        best, rss = None, 0
+        for _ in range(repetitions):
+            code, stderr, elapsed, maxrss = run(cmd)
+            if code != 0:
+                print(f"warning: {stage} of {source} failed:\n{stderr}", file=sys.stderr)
+                return results
+            best = elapsed if best is None else min(best, elapsed)
+            rss = max(rss, maxrss)
+
+        results[stage] = {
+            "seconds": max(best - previous, 0.0),
+            "cumulative_seconds": best,
+            "peak_rss_kb": rss,
+        }
+        if kind:
+            results[stage]["size"] = count_size(kind, output)
+        previous = best
+    return results
+
+
+def collect_sources(paths):
+    sources = []
+    for path in paths:
+        if os.path.isfile(path):
+            sources.append(path)
+            continue
+        for root, _, files in os.walk(path):
+            sources.extend(os.path.join(root, name) for name in files if name.endswith(".c"))
+    return sorted(os.path.normpath(source) for source in sources)
+
+
+def relative_name(source):
+    root = os.path.normpath(os.path.join(SCRIPT_DIR, os.pardir))
+    path = os.path.normpath(source)
+    return os.path.relpath(path, root) if path.startswith(root + os.sep) else path
+
+
+def compare(current, baseline, threshold):
+    regressions = []
+    for name, stages in current["files"].items():
+        for stage, metrics in stages.items():
+            base = baseline.get("files", {}).get(name, {}).get(stage)
+            if not base:
+                continue
+            for metric, floor in (("seconds", MIN_SECONDS), ("peak_rss_kb", MIN_RSS_KB), ("size", 0)):
+                if metric not in metrics or metric not in base:
+                    continue
+                new, old = metrics[metric], base[metric]
+                if new - old <= floor or new <= old * (1 + threshold / 100):
+                    continue
+                change = (new / old - 1) * 100 if old else float("inf")
+                regressions.append((name, stage, metric, old, new, change))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("vast_front", help="vast-front binary to measure")
+    parser.add_argument("corpus", nargs="*", default=DEFAULT_CORPUS, help="C files or directories to compile")
+    parser.add_argument("--output", help="file to write the JSON results to, stdout by default")
+    parser.add_argument("--baseline", help="JSON results of a previous run to compare against")
+    parser.add_argument("--threshold", type=float, default=10.0, help="allowed regression in percent")
+    parser.add_argument("--repetitions", type=int, default=3, help="runs per stage, the best time is reported")
+    parser.add_argument("--target", default="x86_64-unknown-linux-gnu", help="target triple of the compilation")
+    args = parser.parse_args()
+
+    sources = collect_sources(args.corpus)
+    if not sources:
+        sys.exit("empty corpus")
+
+    results = {
+        "vast_front": os.path.abspath(args.vast_front),
+        "target": args.target,
+        "stages": [stage for stage, _, _ in STAGES],
+        "files": {},
+    }
+
+    with tempfile.TemporaryDirectory() as tmp:
+        for source in sources:
+            measured = measure_file(args.vast_front, source, tmp, args.repetitions, ["-target", args.target])
+            results["files"][relative_name(source)] = measured
+
+    if args.output:
+        with open(args.output, "w") as out:
+            json.dump(results, out, indent=2)
+    else:
+        json.dump(results, sys.stdout, indent=2)
+        print()
+
+    if not args.baseline:
+        return
+
+    with open(args.baseline) as base:
+        regressions = compare(results, json.load(base), args.threshold)
+
+    for name, stage, metric, old, new, change in regressions:
+        print(f"regression: {name} {stage} {metric}: {old:g} -> {new:g} ({change:+.1f}%)", file=sys.stderr)
+
+    if regressions:
+        sys.exit(f"{len(regressions)} metrics regressed by more than {args.threshold:g}%")
+    print(f"no regressions beyond {args.threshold:g}%", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
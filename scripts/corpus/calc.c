@@ -0,0 +1,117 @@
+// Recursive descent evaluator of arithmetic expressions.
+
+enum token_kind { tok_num, tok_plus, tok_minus, tok_star, tok_slash, tok_lparen, tok_rparen, tok_end };
+
+struct token {
+    enum token_kind kind;
+    long value;
+};
+
+struct lexer {
+    const char *cursor;
+    struct token current;
+};
+
+static int is_digit(char c) { return c >= '0' && c <= '9'; }
+
+static void next(struct lexer *lex)
+{
+    while (*lex->cursor == ' ') {
+        ++lex->cursor;
+    }
+
+    char c = *lex->cursor;
+    if (is_digit(c)) {
+        long value = 0;
+        while (is_digit(*lex->cursor)) {
+            value = value * 10 + (*lex->cursor++ - '0');
+        }
+        lex->current.kind = tok_num;
+        lex->current.value = value;
+        return;
+    }
+
+    switch (c) {
+        case '+': lex->current.kind = tok_plus; break;
+        case '-': lex->current.kind = tok_minus; break;
+        case '*': lex->current.kind = tok_star; break;
+        case '/': lex->current.kind = tok_slash; break;
+        case '(': lex->current.kind = tok_lparen; break;
+        case ')': lex->current.kind = tok_rparen; break;
+        default: lex->current.kind = tok_end; return;
+    }
+    ++lex->cursor;
+}
+
+static long expression(struct lexer *lex);
+
+static long primary(struct lexer *lex)
+{
+    switch (lex->current.kind) {
+        case tok_num: {
+            long value = lex->current.value;
+            next(lex);
+            return value;
+        }
+        case tok_minus:
+            next(lex);
+            return -primary(lex);
+        case tok_lparen: {
+            next(lex);
+            long value = expression(lex);
+            next(lex);
+            return value;
+        }
+        default:
+            return 0;
+    }
+}
+
+static long term(struct lexer *lex)
+{
+    long value = primary(lex);
+    while (lex->current.kind == tok_star || lex->current.kind == tok_slash) {
+        enum token_kind op = lex->current.kind;
+        next(lex);
+        long rhs = primary(lex);
+        value = op == tok_star ? value * rhs : (rhs ? value / rhs : 0);
+    }
+    return value;
+}
+
+static long expression(struct lexer *lex)
+{
+    long value = term(lex);
+    while (lex->current.kind == tok_plus || lex->current.kind == tok_minus) {
+        enum token_kind op = lex->current.kind;
+        next(lex);
+        long rhs = term(lex);
+        value = op == tok_plus ? value + rhs : value - rhs;
+    }
+    return value;
+}
+
+static long evaluate(const char *src)
+{
+    struct lexer lex = { src, { tok_end, 0 } };
+    next(&lex);
+    return expression(&lex);
+}
+
+int main(void)
+{
+    const char *inputs[] = {
+        "1 + 2 * 3",
+        "(1 + 2) * 3",
+        "-(4 - 10) / 2",
+        "((((7))))",
+        "100 / (5 - 5)",
+    };
+    const long expected[] = { 7, 9, 3, 7, 0 };
+
+    int failures = 0;
+    for (unsigned i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        failures += evaluate(inputs[i]) != expected[i];
+    }
+    return failures;
+}
@@ -0,0 +1,48 @@
+// Table-driven CRC-32 over a pseudo-random buffer.
+
+typedef unsigned int u32;
+typedef unsigned char u8;
+
+static u32 table[256];
+
+static void init_table(void)
+{
+    for (u32 i = 0; i < 256; ++i) {
+        u32 c = i;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table[i] = c;
+    }
+}
+
+static u32 crc32(const u8 *buf, unsigned long len)
+{
+    u32 c = 0xFFFFFFFFu;
+    for (unsigned long i = 0; i < len; ++i) {
+        c = table[(c ^ buf[i]) & 0xFF] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+static u32 xorshift(u32 *state)
+{
+    u32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+int main(void)
+{
+    static u8 buffer[4096];
+    u32 seed = 2463534242u;
+
+    init_table();
+    for (unsigned long i = 0; i < sizeof(buffer); ++i) {
+        buffer[i] = (u8)xorshift(&seed);
+    }
+
+    return (int)(crc32(buffer, sizeof(buffer)) & 0x7F);
+}
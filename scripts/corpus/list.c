@@ -0,0 +1,112 @@
+// Intrusive doubly linked list and a fixed-size pool allocator.
+
+struct node {
+    struct node *prev, *next;
+    int key;
+};
+
+struct list {
+    struct node head;
+    unsigned size;
+};
+
+#define POOL_SIZE 256
+
+static struct node pool[POOL_SIZE];
+static struct node *free_list;
+
+static void pool_init(void)
+{
+    free_list = 0;
+    for (int i = POOL_SIZE - 1; i >= 0; --i) {
+        pool[i].next = free_list;
+        free_list = &pool[i];
+    }
+}
+
+static struct node *pool_alloc(void)
+{
+    struct node *n = free_list;
+    if (n) {
+        free_list = n->next;
+    }
+    return n;
+}
+
+static void pool_free(struct node *n)
+{
+    n->next = free_list;
+    free_list = n;
+}
+
+static void list_init(struct list *l)
+{
+    l->head.prev = l->head.next = &l->head;
+    l->size = 0;
+}
+
+static void insert_after(struct list *l, struct node *pos, struct node *n)
+{
+    n->prev = pos;
+    n->next = pos->next;
+    pos->next->prev = n;
+    pos->next = n;
+    ++l->size;
+}
+
+static void unlink_node(struct list *l, struct node *n)
+{
+    n->prev->next = n->next;
+    n->next->prev = n->prev;
+    --l->size;
+}
+
+static void insert_sorted(struct list *l, int key)
+{
+    struct node *n = pool_alloc();
+    if (!n) {
+        return;
+    }
+    n->key = key;
+
+    struct node *pos = &l->head;
+    while (pos->next != &l->head && pos->next->key < key) {
+        pos = pos->next;
+    }
+    insert_after(l, pos, n);
+}
+
+static int remove_odd(struct list *l)
+{
+    int removed = 0;
+    for (struct node *n = l->head.next, *next; n != &l->head; n = next) {
+        next = n->next;
+        if (n->key & 1) {
+            unlink_node(l, n);
+            pool_free(n);
+            ++removed;
+        }
+    }
+    return removed;
+}
+
+int main(void)
+{
+    struct list l;
+    pool_init();
+    list_init(&l);
+
+    for (int i = 0; i < 200; ++i) {
+        insert_sorted(&l, (i * 37) % 101);
+    }
+
+    int removed = remove_odd(&l);
+    int prev = -1;
+    for (struct node *n = l.head.next; n != &l.head; n = n->next) {
+        if (n->key < prev) {
+            return 1;
+        }
+        prev = n->key;
+    }
+    return (int)l.size + removed == 200 ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+// Dense matrix kernels over statically allocated storage.
+
+#define DIM 32
+
+typedef double matrix[DIM][DIM];
+
+static matrix a, b, c;
+
+static void fill(matrix m, double seed)
+{
+    for (int i = 0; i < DIM; ++i) {
+        for (int j = 0; j < DIM; ++j) {
+            m[i][j] = seed * (i + 1) - j / (seed + 1.0);
+        }
+    }
+}
+
+static void multiply(matrix out, matrix lhs, matrix rhs)
+{
+    for (int i = 0; i < DIM; ++i) {
+        for (int j = 0; j < DIM; ++j) {
+            double acc = 0.0;
+            for (int k = 0; k < DIM; ++k) {
+                acc += lhs[i][k] * rhs[k][j];
+            }
+            out[i][j] = acc;
+        }
+    }
+}
+
+static void transpose(matrix m)
+{
+    for (int i = 0; i < DIM; ++i) {
+        for (int j = i + 1; j < DIM; ++j) {
+            double t = m[i][j];
+            m[i][j] = m[j][i];
+            m[j][i] = t;
+        }
+    }
+}
+
+static double trace(matrix m)
+{
+    double acc = 0.0;
+    for (int i = 0; i < DIM; ++i) {
+        acc += m[i][i];
+    }
+    return acc;
+}
+
+int main(void)
+{
+    fill(a, 1.5);
+    fill(b, 0.25);
+    multiply(c, a, b);
+    double before = trace(c);
+
+    transpose(a);
+    transpose(b);
+    multiply(c, b, a);
+
+    double diff = trace(c) - before;
+    return diff < 1e-6 && diff > -1e-6 ? 0 : 1;
+}
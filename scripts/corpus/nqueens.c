@@ -0,0 +1,37 @@
+// Counts solutions of the n-queens problem by backtracking.
+
+#define N 8
+
+static int columns[N];
+
+static int safe(int row, int col)
+{
+    for (int r = 0; r < row; ++r) {
+        int c = columns[r];
+        if (c == col || c - col == r - row || c - col == row - r) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int solve(int row)
+{
+    if (row == N) {
+        return 1;
+    }
+
+    int count = 0;
+    for (int col = 0; col < N; ++col) {
+        if (safe(row, col)) {
+            columns[row] = col;
+            count += solve(row + 1);
+        }
+    }
+    return count;
+}
+
+int main(void)
+{
+    return solve(0) == 92 ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+// Quicksort, insertion sort and heapsort over the same input.
+
+typedef int (*compare_fn)(int, int);
+
+static int less(int a, int b) { return a < b; }
+static int greater(int a, int b) { return a > b; }
+
+static void swap(int *a, int *b)
+{
+    int t = *a;
+    *a = *b;
+    *b = t;
+}
+
+static void insertion_sort(int *data, int n, compare_fn cmp)
+{
+    for (int i = 1; i < n; ++i) {
+        int key = data[i];
+        int j = i - 1;
+        while (j >= 0 && cmp(key, data[j])) {
+            data[j + 1] = data[j];
+            --j;
+        }
+        data[j + 1] = key;
+    }
+}
+
+static int partition(int *data, int lo, int hi, compare_fn cmp)
+{
+    int pivot = data[hi];
+    int i = lo;
+    for (int j = lo; j < hi; ++j) {
+        if (cmp(data[j], pivot)) {
+            swap(&data[i++], &data[j]);
+        }
+    }
+    swap(&data[i], &data[hi]);
+    return i;
+}
+
+static void quick_sort(int *data, int lo, int hi, compare_fn cmp)
+{
+    while (lo < hi) {
+        if (hi - lo < 8) {
+            insertion_sort(data + lo, hi - lo + 1, cmp);
+            return;
+        }
+
+        int p = partition(data, lo, hi, cmp);
+        if (p - lo < hi - p) {
+            quick_sort(data, lo, p - 1, cmp);
+            lo = p + 1;
+        } else {
+            quick_sort(data, p + 1, hi, cmp);
+            hi = p - 1;
+        }
+    }
+}
+
+static void sift_down(int *data, int root, int n, compare_fn cmp)
+{
+    for (;;) {
+        int child = 2 * root + 1;
+        if (child >= n) {
+            break;
+        }
+        if (child + 1 < n && cmp(data[child], data[child + 1])) {
+            ++child;
+        }
+        if (!cmp(data[root], data[child])) {
+            break;
+        }
+        swap(&data[root], &data[child]);
+        root = child;
+    }
+}
+
+static void heap_sort(int *data, int n, compare_fn cmp)
+{
+    for (int i = n / 2 - 1; i >= 0; --i) {
+        sift_down(data, i, n, cmp);
+    }
+    for (int i = n - 1; i > 0; --i) {
+        swap(&data[0], &data[i]);
+        sift_down(data, 0, i, cmp);
+    }
+}
+
+static int sorted(const int *data, int n, compare_fn cmp)
+{
+    for (int i = 1; i < n; ++i) {
+        if (cmp(data[i], data[i - 1])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+#define SIZE 512
+
+int main(void)
+{
+    int a[SIZE], b[SIZE];
+    unsigned state = 12345;
+
+    for (int i = 0; i < SIZE; ++i) {
+        state = state * 1103515245u + 12345u;
+        a[i] = b[i] = (int)(state >> 16) % 1000;
+    }
+
+    quick_sort(a, 0, SIZE - 1, less);
+    heap_sort(b, SIZE, less);
+
+    int result = sorted(a, SIZE, less) + sorted(b, SIZE, less);
+    quick_sort(a, 0, SIZE - 1, greater);
+    return result + sorted(a, SIZE, greater) == 3 ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+# Copyright (c) 2023-present, Trail of Bits, Inc.
+
+"""
+Times vast codegen of a generated C++ file dominated by name mangling.
+
+The file declares groups of overloaded functions and callers that
+reference every overload many times, so most mangled name requests are
+repeated lookups of already mangled decls. Compare two builds by passing
+`--baseline`:
+
+    scripts/mangling-bench.py builds/new/tools/vast-front/Release/vast-front \\
+        --baseline builds/old/tools/vast-front/Release/vast-front
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+PARAMETER_TYPES = ["int", "long", "unsigned", "short", "char", "float", "double", "long long"]
+
+
+def generate(path, groups, calls):
+    with open(path, "w") as out:
+        for group in range(groups):
+            for ty in PARAMETER_TYPES:
+                out.write(f"int overload_{group}({ty} v) {{ return (int)v + {group}; }}\n")
+
+            out.write(f"int caller_{group}(int v) {{\n    int acc = 0;\n")
+            for _ in range(calls):
+                for ty in PARAMETER_TYPES:
+                    out.write(f"    acc += overload_{group}(({ty})v);\n")
+            out.write("    return acc;\n}\n")
+
+
+def measure(vast_front, source, repetitions):
+    cmd = [vast_front, "-cc1", "-x", "c++", "-vast-emit-mlir=hl", source, "-o", os.devnull]
+    best = None
+    for _ in range(repetitions):
+        start = time.perf_counter()
+        result = subprocess.run(cmd, capture_output=True, text=True)
+        elapsed = time.perf_counter() - start
+        if result.returncode != 0:
+            sys.exit(f"{vast_front} failed:\n{result.stderr}")
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("vast_front", help="vast-front binary to measure")
+    parser.add_argument("--baseline", help="vast-front binary to compare against")
+    parser.add_argument("--groups", type=int, default=500, help="number of overload groups")
+    parser.add_argument("--calls", type=int, default=20, help="references of each overload per caller")
+    parser.add_argument("--repetitions", type=int, default=5, help="runs per binary, the best is reported")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmp:
+        source = os.path.join(tmp, "mangling-bench.cpp")
+        generate(source, args.groups, args.calls)
+
+        elapsed = measure(args.vast_front, source, args.repetitions)
+        print(f"{args.vast_front}: {elapsed:.3f} s")
+
+        if args.baseline:
+            base = measure(args.baseline, source, args.repetitions)
+            print(f"{args.baseline}: {base:.3f} s")
+            print(f"speedup: {base / elapsed:.2f}x")
+
+
+if __name__ == "__main__":
+    main()
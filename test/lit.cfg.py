@@ -61,6 +61,7 @@ tools = [
     ToolSubst('%vast-query', command = 'vast-query'),
     ToolSubst('%vast-front', command = 'vast-front'),
     ToolSubst('%vast-repl', command = 'vast-repl'),
+    ToolSubst('%vast-run', command = 'vast-run'),
     ToolSubst('%vast-cc1', command = 'vast-front',
         extra_args=[
             "-cc1",
@@ -69,6 +70,7 @@ tools = [
         ]
     ),
     ToolSubst('%file-check', command = 'FileCheck'),
+    ToolSubst('%llvm-nm', command = 'llvm-nm'),
     ToolSubst('%clang', command = 'clang-17')
 ]
 
@@ -82,3 +84,9 @@ for tool in tools:
         path = [config.vast_tools_dir, tool.command, config.vast_build_type]
         tool.command = os.path.join(*path, tool.command)
     llvm_config.add_tool_substitutions([tool])
+
+# Runtime linked into programs instrumented by `-vast-instrument-profile`.
+config.substitutions.append(('%vast-profile-rt', os.path.join(
+    config.vast_obj_root, 'runtime', 'profile', config.vast_build_type,
+    'libvast_profile_rt' + config.llvm_shlib_ext
+)))
@@ -0,0 +1,26 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t.mlir
+// RUN: %vast-run %t.mlir first second | %file-check %s
+// RUN: rm -rf %t.cache
+// RUN: %vast-run -cache-dir=%t.cache %t.mlir first | %file-check %s -check-prefix=ONE
+// RUN: ls %t.cache | %file-check %s -check-prefix=CACHE
+// RUN: %vast-run -cache-dir=%t.cache %t.mlir first | %file-check %s -check-prefix=ONE
+// RUN: not %vast-run %t.mlir fail
+
+int puts(const char *);
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == 'f' && argv[i][1] == 'a')
+            return 1;
+        puts(argv[i]);
+    }
+    return 0;
+}
+
+// CHECK: first
+// CHECK-NEXT: second
+
+// ONE: first
+// ONE-NOT: second
+
+// CACHE: {{[0-9a-f]+}}-O0.o
@@ -0,0 +1,63 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl -vast-instrument-profile %s -o %t.mlir
+// RUN: rm -f %t.prof
+// RUN: env VAST_PROFILE_FILE=%t.prof %vast-run -shared-libs=%vast-profile-rt %t.mlir
+// RUN: %file-check %s -check-prefix=PROF < %t.prof
+// RUN: %vast-opt --vast-hl-profile-use="profile=%t.prof" %t.mlir | %file-check %s
+// RUN: %vast-opt --vast-hl-profile-use="profile=%t.prof" %t.mlir \
+// RUN:   | %vast-opt --vast-hl-dce --vast-hl-lower-types --vast-hl-to-ll-cf \
+// RUN:   | %file-check %s -check-prefix=LL
+
+// PROF-DAG: classify:entry:{{.*}}	100
+// PROF-DAG: classify:if.then:{{.*}}	9
+// PROF-DAG: main:entry:{{.*}}	1
+// PROF-DAG: main:for.body:{{.*}}	100
+
+int classify(int x) {
+    // CHECK: hl.if
+    // CHECK: vast.core.branch_weights = array<i32: 9, 91>
+    if (x > 90)
+        return 1;
+    return 0;
+}
+
+// Counts after an early exit are propagated, not taken from the function.
+int rank(int x) {
+    // CHECK: hl.if
+    // CHECK: vast.core.branch_weights = array<i32: 50, 50>
+    if (x < 50)
+        return 0;
+    // CHECK: hl.if
+    // CHECK: vast.core.branch_weights = array<i32: 25, 25>
+    if (x < 75)
+        return 1;
+    return 2;
+}
+
+// The loop is left only through the break.
+int find(int n) {
+    int i = 0;
+    // CHECK: hl.while
+    // CHECK: hl.if
+    // CHECK: vast.core.branch_weights = array<i32: 1, 10>
+    // CHECK: vast.core.branch_weights = array<i32: 11, 0>
+    while (i < 100) {
+        if (i == n)
+            break;
+        ++i;
+    }
+    return i;
+}
+
+int main(void) {
+    int hits = 0, ranks = 0;
+    // CHECK: hl.for
+    // CHECK: vast.core.branch_weights = array<i32: 100, 1>
+    for (int i = 0; i < 100; ++i) {
+        hits += classify(i);
+        ranks += rank(i);
+    }
+    return hits == 9 && ranks == 75 && find(10) == 10 ? 0 : 1;
+}
+
+// LL: ll.cond_br {{.*}}vast.core.branch_weights = array<i32: 9, 91>
+// LL: ll.cond_scope_ret {{.*}}vast.core.branch_weights = array<i32: 100, 1>
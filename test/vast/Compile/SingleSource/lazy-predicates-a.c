@@ -0,0 +1,27 @@
+// RUN: %vast-front -o %t %s && (%t; test $? -eq 42)
+
+// Predicate heavy loop, operands of `&&`, `||` and `?:` are cheap enough to
+// be evaluated without branching.
+int count(int *v, int n, int lo, int hi)
+{
+    int c = 0;
+    for (int i = 0; i < n; ++i) {
+        int x = v[i];
+        c += (x >= lo && x < hi) || x == 100 ? 1 : 0;
+    }
+    return c;
+}
+
+int safe_div(int a, int b)
+{
+    return b != 0 && a / b > 1 ? a / b : 0;
+}
+
+int main()
+{
+    int v[64];
+    for (int i = 0; i < 64; ++i)
+        v[i] = i * 3;
+    // Multiples of three in [10, 100) are 12 to 99, that is 30 values.
+    return count(v, 64, 10, 100) + safe_div(24, 2) + safe_div(1, 0);
+}
@@ -0,0 +1,36 @@
+// RUN: %vast-cc1 -triple x86_64-unknown-linux-gnu -vast-emit-mlir=llvm %s -o %t.mlir
+// RUN: %file-check --input-file=%t.mlir %s -check-prefix=O0
+// RUN: %vast-cc1 -triple x86_64-unknown-linux-gnu -vast-emit-mlir=llvm -vast-opt-level=2 %s -o %t.opt.mlir
+// RUN: %file-check --input-file=%t.opt.mlir %s -check-prefix=O2
+
+static int add(int a, int b) {
+    return a + b;
+}
+
+int inc(int x) {
+    return add(x, 1);
+}
+
+int twice(int x) {
+    int y = x + 1;
+    return y * 2;
+}
+
+//  O0-LABEL: llvm.func @inc
+//        O0:   llvm.call @add
+//        O0:   llvm.return
+
+//  O0-LABEL: llvm.func @twice
+//        O0:   llvm.alloca
+//        O0:   llvm.alloca
+//        O0:   llvm.return
+
+//  O2-LABEL: llvm.func @inc
+//    O2-NOT:   llvm.call
+//        O2:   llvm.return
+
+// Only the parameter keeps its slot, `y` is promoted.
+//  O2-LABEL: llvm.func @twice
+//        O2:   llvm.alloca
+//    O2-NOT:   llvm.alloca
+//        O2:   llvm.return
@@ -0,0 +1,26 @@
+// RUN: %vast-cc1 -triple x86_64-unknown-linux-gnu -vast-emit-mlir=llvm -vast-profile-ir=json %s -o %t.mlir 2> %t.json
+// RUN: %file-check --input-file=%t.json %s -check-prefix=JSON
+// RUN: %vast-cc1 -triple x86_64-unknown-linux-gnu -vast-emit-mlir=hl -vast-profile-ir %s -o %t.mlir 2> %t.txt
+// RUN: %file-check --input-file=%t.txt %s -check-prefix=TABLE
+
+// JSON: "pass": "vast-hl-splice-trailing-scopes"
+// JSON: "runs": 1
+// JSON: "before": {
+// JSON: "dialects": {
+// JSON: "hl":
+// JSON: "op_names": {
+// JSON: "hl.func":
+// JSON: "pass": "vast-irs-to-llvm"
+// JSON: "after": {
+// JSON: "llvm.func":
+
+// TABLE: pass {{ +}}runs {{ +}}time [s] {{ +}}ops {{ +}}blocks {{ +}}regions {{ +}}attributes {{ +}}types
+// TABLE-NEXT: vast-hl-splice-trailing-scopes {{ +}}1
+
+int sum(int n) {
+    int acc = 0;
+    for (int i = 0; i < n; ++i) {
+        acc += i;
+    }
+    return acc;
+}
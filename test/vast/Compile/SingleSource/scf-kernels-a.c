@@ -0,0 +1,49 @@
+// RUN: %vast-front -vast-pipeline=with-scf -o %t %s && (%t; test $? -eq 42)
+// RUN: %vast-front -O2 -vast-pipeline=with-scf -o %t %s && (%t; test $? -eq 42)
+
+int dot(int *a, int *b, int n)
+{
+    int s = 0;
+    for (int i = 0; i < n; ++i)
+        s += a[i] * b[i];
+    return s;
+}
+
+void axpy(int k, int *x, int *y, int n)
+{
+    for (int i = 0; i < n; i += 2) {
+        y[i] += k * x[i];
+        if (i + 1 < n)
+            y[i + 1] += k * x[i + 1];
+    }
+}
+
+int triangle(int n)
+{
+    int s = 0;
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < i; j++)
+            s++;
+    return s;
+}
+
+int main()
+{
+    int a[5] = { 1, 2, 3, 4, 5 };
+    int b[5] = { 5, 4, 3, 2, 1 };
+    if (dot(a, b, 5) != 35)
+        return 1;
+
+    axpy(2, a, b, 5);
+    if (b[0] != 7 || b[4] != 11)
+        return 2;
+
+    if (triangle(5) != 10)
+        return 3;
+
+    int i = 0;
+    do {
+        i += 3;
+    } while (i < 42);
+    return i;
+}
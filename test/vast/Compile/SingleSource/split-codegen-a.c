@@ -0,0 +1,38 @@
+// RUN: %vast-cc1 -triple x86_64-unknown-linux-gnu -vast-emit-obj -vast-codegen-partitions=3 %s -o %t.a.o
+// RUN: %vast-cc1 -triple x86_64-unknown-linux-gnu -vast-emit-obj -vast-codegen-partitions=3 %s -o %t.b.o
+// RUN: cmp %t.a.o %t.b.o
+// RUN: %llvm-nm %t.a.o | %file-check %s
+// RUN: %clang -c -xc %s.driver -o %t.driver.o
+// RUN: %clang %t.a.o %t.driver.o -o %t && %t
+
+static int counter;
+
+static int square(int x) {
+    return x * x;
+}
+
+int sum_of_squares(int n) {
+    int sum = 0;
+    for (int i = 1; i <= n; ++i)
+        sum += square(i);
+    return sum;
+}
+
+int bump(void) {
+    return ++counter;
+}
+
+int driver_globals_intact(void);
+
+int main(void) {
+    bump();
+    return sum_of_squares(3) == 14 && bump() == 2 && driver_globals_intact() ? 0 : 1;
+}
+
+// Statics stay local (lowercase), so they do not clash with the globals of
+// the same name in the driver.
+// CHECK-DAG: {{ b counter$}}
+// CHECK-DAG: {{ t square$}}
+// CHECK-DAG: {{ T sum_of_squares$}}
+// CHECK-DAG: {{ T bump$}}
+// CHECK-DAG: {{ T main$}}
@@ -0,0 +1,49 @@
+// RUN: %vast-front -o %t %s && (%t; test $? -eq 42)
+
+// Small bytecode interpreter, the dispatch `switch` is lowered to a jump table.
+
+enum opcode { PUSH, ADD, SUB, MUL, DUP, SWAP, JNZ, HALT };
+
+int run(const int *code)
+{
+    int stack[ 16 ];
+    int sp = 0;
+    int pc = 0;
+
+    for (;;) {
+        switch (code[ pc++ ]) {
+            case PUSH: stack[ sp++ ] = code[ pc++ ]; break;
+            case ADD: sp--; stack[ sp - 1 ] = stack[ sp - 1 ] + stack[ sp ]; break;
+            case SUB: sp--; stack[ sp - 1 ] = stack[ sp - 1 ] - stack[ sp ]; break;
+            case MUL: sp--; stack[ sp - 1 ] = stack[ sp - 1 ] * stack[ sp ]; break;
+            case DUP: stack[ sp ] = stack[ sp - 1 ]; sp++; break;
+            case SWAP: {
+                int tmp = stack[ sp - 1 ];
+                stack[ sp - 1 ] = stack[ sp - 2 ];
+                stack[ sp - 2 ] = tmp;
+                break;
+            }
+            case JNZ:
+                if (stack[ --sp ])
+                    pc = code[ pc ];
+                else
+                    pc++;
+                break;
+            case HALT:
+                return stack[ sp - 1 ];
+            default:
+                return -1;
+        }
+    }
+}
+
+int main()
+{
+    // acc = 0; n = 6; do { acc += 7; n -= 1; } while (n); return acc;
+    int code[] = {
+        PUSH, 0, PUSH, 6,
+        SWAP, PUSH, 7, ADD, SWAP, PUSH, 1, SUB, DUP, JNZ, 4,
+        SWAP, HALT
+    };
+    return run(code);
+}
@@ -0,0 +1,32 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types --vast-hl-to-ll-cf --vast-hl-to-ll-vars --vast-hl-to-lazy-regions --vast-irs-to-llvm --vast-core-to-llvm | %file-check %s
+
+int fun(int arg1, int arg2) {
+    // CHECK: [[LHS:%[0-9]+]] = llvm.load [[V1:%[0-9]+]]
+    // CHECK: [[RHS:%[0-9]+]] = llvm.load [[V2:%[0-9]+]]
+    // CHECK: [[LR:%[0-9]+]] = llvm.icmp "ne" [[LHS]], {{%[0-9]+}} : i32
+    // CHECK: [[RR:%[0-9]+]] = llvm.icmp "ne" [[RHS]], {{%[0-9]+}} : i32
+    // CHECK: [[FALSE:%[0-9]+]] = llvm.mlir.constant(false) : i1
+    // CHECK: [[AND:%[0-9]+]] = llvm.select [[LR]], [[RR]], [[FALSE]] : i1, i1
+    // CHECK: llvm.zext [[AND]] : i1 to i32
+    // CHECK-NOT: llvm.cond_br
+    int res = arg1 && arg2;
+    return res;
+}
+
+int div(int a, int b) {
+    // Division may trap, the right hand side stays guarded.
+    // CHECK: llvm.cond_br
+    // CHECK: llvm.sdiv
+    return b != 0 && a / b > 2;
+}
+
+int shift(int x, int n) {
+    // The shift is poison for n >= 32, select keeps it from the result.
+    // CHECK: llvm.func @shift
+    // CHECK: [[SHL:%[0-9]+]] = llvm.shl
+    // CHECK: [[RR:%[0-9]+]] = llvm.icmp "ne" [[SHL]], {{%[0-9]+}} : i32
+    // CHECK: llvm.select {{%[0-9]+}}, [[RR]], {{%[0-9]+}} : i1, i1
+    // CHECK-NOT: llvm.and
+    // CHECK: llvm.return
+    return n < 32 && (x << n);
+}
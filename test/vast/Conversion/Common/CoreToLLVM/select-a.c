@@ -0,0 +1,21 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types --vast-hl-to-ll-cf --vast-hl-to-ll-vars --vast-hl-to-lazy-regions --vast-irs-to-llvm --vast-core-to-llvm | %file-check %s
+
+int max(int a, int b) {
+    // CHECK: [[C:%[0-9]+]] = llvm.icmp "ne" {{.*}} : i32
+    // CHECK: llvm.select [[C]], {{%[0-9]+}}, {{%[0-9]+}} : i1, i32
+    // CHECK-NOT: llvm.cond_br
+    return a > b ? a : b;
+}
+
+int call(int);
+
+int guarded(int a) {
+    // CHECK: llvm.cond_br {{%[0-9]+}}, ^[[THEN:bb[0-9]+]], ^[[ELSE:bb[0-9]+]]
+    // CHECK: ^[[THEN]]:
+    // CHECK: llvm.call @call
+    // CHECK: llvm.br ^[[END:bb[0-9]+]]({{%[0-9]+}} : i32)
+    // CHECK: ^[[ELSE]]:
+    // CHECK: llvm.br ^[[END]]({{%[0-9]+}} : i32)
+    // CHECK: ^[[END]]({{%[0-9]+}}: i32):
+    return a ? call(a) : 0;
+}
@@ -0,0 +1,9 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types --vast-hl-to-ll-cf --vast-hl-to-ll-vars --vast-irs-to-llvm | %file-check %s
+
+// CHECK: llvm.mlir.global internal constant @table(dense<[1, 2, 4, 8, 16, 32, 64, 128, 0, 0, 0, 0, 0, 0, 0, 0]> : tensor<16xi32>)
+// CHECK-SAME: !llvm.array<16 x i32>
+// CHECK-NOT: llvm.insertvalue
+const int table[16] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+
+// CHECK: llvm.mlir.global internal @scratch(dense<[1, 2, 0, 0]> : tensor<4xi32>)
+int scratch[4] = { 1, 2 };
@@ -0,0 +1,18 @@
+// RUN: %vast-cc1 -vast-emit-mlir=llvm -vast-instrument-profile %s -o - | %file-check %s
+
+// CHECK-NOT: llvm.func @__vast_prof_inc
+// CHECK: llvm.func @__vast_prof_register
+// CHECK: llvm.func internal @__vast_prof_init()
+// CHECK:   llvm.call @__vast_prof_register
+
+// CHECK-LABEL: llvm.func @branches
+// CHECK:   [[SLOT:%[0-9]+]] = llvm.getelementptr
+// CHECK:   llvm.atomicrmw add [[SLOT]], {{%[0-9]+}} monotonic
+// CHECK-NOT: llvm.call @__vast_prof_inc
+int branches(int a) {
+    if (a)
+        return 1;
+    return 0;
+}
+
+// CHECK: llvm.mlir.global_ctors {ctors = [@__vast_prof_init], priorities = [65535 : i32]}
@@ -0,0 +1,16 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types --vast-hl-to-ll-cf --vast-hl-to-ll-vars --vast-irs-to-llvm | %file-check %s
+
+// CHECK-DAG: [[DOMAIN:#.*]] = #llvm.alias_scope_domain<{{.*}}description = "copy">
+// CHECK-DAG: [[DST:#.*]] = #llvm.alias_scope<id = {{.*}}, domain = [[DOMAIN]], description = "copy: restrict #0">
+// CHECK-DAG: [[SRC:#.*]] = #llvm.alias_scope<id = {{.*}}, domain = [[DOMAIN]], description = "copy: restrict #1">
+
+// CHECK: llvm.func @copy(%arg0: !llvm.ptr<i32> {llvm.noalias}, %arg1: !llvm.ptr<i32> {llvm.noalias}, %arg2: !llvm.ptr<i32>)
+void copy(int *restrict dst, int *restrict src, int *other)
+{
+    // CHECK: llvm.load {{.*}} {alias_scopes = {{\[}}[[SRC]]{{\]}}, noalias_scopes = {{\[}}[[DST]]{{\]}}}
+    // CHECK: llvm.store {{.*}} {alias_scopes = {{\[}}[[DST]]{{\]}}, noalias_scopes = {{\[}}[[SRC]]{{\]}}}
+    dst[0] = src[0];
+    // CHECK-NOT: alias_scopes
+    other[0] = 1;
+}
+// CHECK: }
@@ -0,0 +1,37 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types --vast-hl-to-ll-cf --vast-hl-to-ll-vars --vast-irs-to-llvm | %file-check %s
+
+// Restrict locals may be based on the parameters or on each other, only
+// accesses through unmodified restrict parameters are scoped.
+
+// CHECK-DAG: [[P:#.*]] = #llvm.alias_scope<id = {{.*}}, domain = {{.*}}, description = "nested: restrict #0">
+// CHECK-DAG: [[B:#.*]] = #llvm.alias_scope<id = {{.*}}, domain = {{.*}}, description = "reassigned: restrict #0">
+
+// CHECK: llvm.func @nested(%arg0: !llvm.ptr<i32> {llvm.noalias})
+// CHECK-NOT: alias_scopes
+// CHECK: llvm.load {{.*}} {alias_scopes = {{\[}}[[P]]{{\]}}}
+// CHECK-NOT: noalias_scopes
+// CHECK: llvm.return
+int nested(int *restrict p)
+{
+    {
+        int *restrict q = p;
+        q[0] = 1;
+    }
+    {
+        int *restrict r = p;
+        r[1] = 2;
+    }
+    return p[0];
+}
+
+// CHECK: llvm.func @reassigned(%arg0: !llvm.ptr<i32> {llvm.noalias}, %arg1: !llvm.ptr<i32> {llvm.noalias})
+// CHECK-NOT: alias_scopes
+// CHECK: llvm.load {{.*}} {alias_scopes = {{\[}}[[B]]{{\]}}}
+// CHECK-NOT: noalias_scopes
+// CHECK: llvm.return
+int reassigned(int *restrict a, int *restrict b)
+{
+    a = b;
+    a[0] = 1;
+    return b[0];
+}
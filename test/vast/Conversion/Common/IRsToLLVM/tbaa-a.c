@@ -0,0 +1,29 @@
+// RUN: %vast-cc1 -O2 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types --vast-hl-to-ll-cf --vast-hl-to-ll-vars --vast-hl-to-ll-geps --vast-hl-structs-to-llvm --vast-irs-to-llvm | %file-check %s
+// RUN: %vast-cc1 -O2 -fno-strict-aliasing -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types --vast-hl-to-ll-cf --vast-hl-to-ll-vars --vast-hl-to-ll-geps --vast-hl-structs-to-llvm --vast-irs-to-llvm | %file-check %s --check-prefix=RELAXED
+
+// CHECK-DAG: [[ROOT:#.*]] = #llvm.tbaa_root<id = "Simple C/C++ TBAA">
+// CHECK-DAG: [[CHAR:#.*]] = #llvm.tbaa_type_desc<id = "omnipotent char", members = {<[[ROOT]], 0>}>
+// CHECK-DAG: [[INT:#.*]] = #llvm.tbaa_type_desc<id = "int", members = {<[[CHAR]], 0>}>
+// CHECK-DAG: [[FLOAT:#.*]] = #llvm.tbaa_type_desc<id = "float", members = {<[[CHAR]], 0>}>
+// CHECK-DAG: [[PAIR:#.*]] = #llvm.tbaa_type_desc<id = "pair", members = {<[[INT]], 0>, <[[FLOAT]], 4>}>
+// CHECK-DAG: [[INT_TAG:#.*]] = #llvm.tbaa_tag<base_type = [[INT]], access_type = [[INT]], offset = 0>
+// CHECK-DAG: [[CHAR_TAG:#.*]] = #llvm.tbaa_tag<base_type = [[CHAR]], access_type = [[CHAR]], offset = 0>
+// CHECK-DAG: [[FLOAT_TAG:#.*]] = #llvm.tbaa_tag<base_type = [[PAIR]], access_type = [[FLOAT]], offset = 4>
+
+// RELAXED-NOT: tbaa
+
+struct pair { int a; float b; };
+
+int scalar(int *p, char *c)
+{
+    // CHECK: llvm.store {{.*}} {tbaa = {{\[}}[[CHAR_TAG]]{{\]}}} : !llvm.ptr<i8>
+    *c = 0;
+    // CHECK: llvm.load {{.*}} {tbaa = {{\[}}[[INT_TAG]]{{\]}}} : !llvm.ptr<i32>
+    return *p;
+}
+
+float member(struct pair *s)
+{
+    // CHECK: llvm.load {{.*}} {tbaa = {{\[}}[[FLOAT_TAG]]{{\]}}} : !llvm.ptr<f32>
+    return s->b;
+}
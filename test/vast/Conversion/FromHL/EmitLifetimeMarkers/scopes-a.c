@@ -0,0 +1,38 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types --vast-hl-to-ll-func --vast-hl-to-ll-vars --vast-hl-to-ll-cf --vast-emit-lifetime-markers | %file-check %s
+
+void sink(int *);
+
+// CHECK: ll.func {{.*}} @disjoint
+void disjoint(int c)
+{
+    // CHECK: [[A:%[0-9]+]] = ll.uninitialized_var
+    // CHECK: [[B:%[0-9]+]] = ll.uninitialized_var
+    // CHECK: [[X:%[0-9]+]] = ll.uninitialized_var
+    int x = c;
+    if (c) {
+        // CHECK: ll.lifetime.start [[A]]
+        // CHECK: ll.lifetime.end [[A]]
+        int a[64];
+        sink(a);
+    } else {
+        // CHECK: ll.lifetime.start [[B]]
+        // CHECK: ll.lifetime.end [[B]]
+        int b[64];
+        sink(b);
+    }
+    // CHECK-NOT: ll.lifetime.start [[X]]
+}
+
+// CHECK: ll.func {{.*}} @loop
+void loop(int n)
+{
+    // CHECK: [[T:%[0-9]+]] = ll.uninitialized_var
+    while (n--) {
+        // CHECK: ll.lifetime.start [[T]]
+        int t[16];
+        sink(t);
+        // CHECK: ll.lifetime.end [[T]]
+        if (n == 4)
+            break;
+    }
+}
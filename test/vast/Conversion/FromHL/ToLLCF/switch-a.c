@@ -0,0 +1,23 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-dce --vast-hl-lower-types --vast-hl-to-ll-cf | %file-check %s
+
+int fn(int num)
+{
+    int v = 0;
+    // CHECK: ll.switch {{%[0-9]+}} : si32, [[DEFAULT:\^bb[0-9]+]] {{\[}}[[ONE:\^bb[0-9]+]], [[TWO:\^bb[0-9]+]], [[THREE:\^bb[0-9]+]]] {case_values = dense<[1, 2, 3]> : vector<3xi32>}
+    switch (num) {
+        // CHECK: [[ONE]]:
+        // CHECK: ll.br [[TWO]]
+        case 1: v++;
+        // CHECK: [[TWO]]:
+        // CHECK: ll.br [[TAIL:\^bb[0-9]+]]
+        case 2: v++; break;
+        // CHECK: [[THREE]]:
+        // CHECK: ll.return
+        case 3: return 3;
+        // CHECK: [[DEFAULT]]:
+        // CHECK: ll.br [[TAIL]]
+        default: v = 10;
+    }
+    // CHECK: [[TAIL]]:
+    return v;
+}
@@ -0,0 +1,47 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types --vast-hl-to-scf | %file-check %s
+
+// CHECK-LABEL: hl.func @sum
+int sum(int *a, int n)
+{
+    int s = 0;
+    // CHECK: [[LB:%[0-9]+]] = hl.implicit_cast {{.*}} IntegralCast : si32 -> i32
+    // CHECK: [[UB:%[0-9]+]] = hl.implicit_cast {{.*}} IntegralCast : si32 -> i32
+    // CHECK: [[STEP:%.*]] = arith.constant 1 : i32
+    // CHECK: scf.for [[IV:%.*]] = [[LB]] to [[UB]] step [[STEP]] : i32 {
+    // CHECK:   [[V:%[0-9]+]] = hl.implicit_cast [[IV]] IntegralCast : i32 -> si32
+    // CHECK:   hl.assign [[V]] to
+    // CHECK:   hl.assign.add
+    // CHECK: }
+    for (int i = 0; i < n; ++i)
+        s += a[i];
+    return s;
+}
+
+// CHECK-LABEL: hl.func @count
+int count(int n)
+{
+    // CHECK: scf.while : () -> () {
+    // CHECK:   [[C:%[0-9]+]] = hl.implicit_cast {{.*}} IntegralToBoolean : si32 -> i1
+    // CHECK:   scf.condition([[C]])
+    // CHECK: } do {
+    // CHECK:   hl.post.dec
+    // CHECK:   scf.yield
+    // CHECK: }
+    int c = 0;
+    while (n > 0) {
+        c++;
+        n--;
+    }
+    return c;
+}
+
+// CHECK-LABEL: hl.func @early
+int early(int n)
+{
+    // CHECK-NOT: scf.for
+    // CHECK: hl.for
+    for (int i = 0; i < n; ++i)
+        if (i == 3)
+            break;
+    return n;
+}
@@ -0,0 +1,23 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types --vast-hl-to-scf --convert-scf-to-cf --vast-hl-to-ll-cf | %file-check %s
+
+// Lowering `scf` to unstructured control flow leaves `hl` statements of the
+// loop body in blocks of the function body, `hl.if` is lowered in there.
+
+// CHECK-LABEL: hl.func @clamp
+void clamp(int *a, int n)
+{
+    // CHECK-NOT: hl.if
+    // CHECK: cf.cond_br {{%[0-9]+}}, ^[[BODY:bb[0-9]+]], ^[[EXIT:bb[0-9]+]]
+    // CHECK: ^[[BODY]]:
+    // CHECK:   ll.cond_br {{%[0-9]+}} : i1, ^[[THEN:bb[0-9]+]], ^[[TAIL:bb[0-9]+]]
+    // CHECK: ^[[THEN]]:
+    // CHECK:   hl.assign
+    // CHECK:   ll.br ^[[TAIL]]
+    // CHECK: ^[[TAIL]]:
+    // CHECK:   cf.br
+    // CHECK: ^[[EXIT]]:
+    // CHECK-NOT: hl.if
+    for (int i = 0; i < n; ++i)
+        if (a[i] > 255)
+            a[i] = 255;
+}
@@ -0,0 +1,28 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types --vast-hl-to-scf --vast-scf-unroll="factor=2" | %file-check %s
+
+// CHECK-LABEL: hl.func @sum
+int sum(int *a, int n)
+{
+    int s = 0;
+    // CHECK: [[STEP:%.*]] = arith.constant 1 : i32
+    // CHECK: [[MAX:%.*]] = arith.maxsi [[UB:%[0-9]+]], [[LB:%[0-9]+]] : i32
+    // CHECK: [[SPAN:%.*]] = arith.subi [[MAX]], [[LB]] : i32
+    // CHECK: [[BY:%.*]] = arith.constant 2 : i32
+    // CHECK: [[TRIPS:%.*]] = arith.divui [[SPAN]], [[BY]] : i32
+    // CHECK: [[LEN:%.*]] = arith.muli [[TRIPS]], [[BY]] : i32
+    // CHECK: [[SPLIT:%.*]] = arith.addi [[LB]], [[LEN]] : i32
+    // CHECK: scf.for [[IV:%.*]] = [[LB]] to [[SPLIT]] step [[BY]] : i32 {
+    // CHECK:   hl.implicit_cast [[IV]] IntegralCast : i32 -> si32
+    // CHECK:   hl.assign.add
+    // CHECK:   [[NEXT:%.*]] = arith.addi [[IV]], {{%.*}} : i32
+    // CHECK:   hl.implicit_cast [[NEXT]] IntegralCast : i32 -> si32
+    // CHECK:   hl.assign.add
+    // CHECK: }
+    // CHECK: scf.for [[REM:%.*]] = [[SPLIT]] to [[UB]] step [[STEP]] : i32 {
+    // CHECK:   hl.implicit_cast [[REM]] IntegralCast : i32 -> si32
+    // CHECK:   hl.assign.add
+    // CHECK: }
+    for (int i = 0; i < n; ++i)
+        s += a[i];
+    return s;
+}
@@ -0,0 +1,23 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %file-check %s
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t && %vast-opt %t | diff -B %t -
+
+// CHECK: hl.var "table" : !hl.lvalue<!hl.array<16, !hl.int< unsigned, const >>> = {
+// CHECK:   [[V1:%[0-9]+]] = hl.initlist.dense dense<[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15]> : tensor<16xi32> : !hl.array<16, !hl.int< unsigned, const >>
+// CHECK:   hl.value.yield [[V1]]
+static const unsigned table[16] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+};
+
+// CHECK: hl.var "matrix" : !hl.lvalue<!hl.array<4, !hl.array<4, !hl.float>>> = {
+// CHECK:   hl.initlist.dense dense<{{\[\[}}1.000000e+00, 0.000000e+00, 0.000000e+00, 0.000000e+00], {{.*}}]> : tensor<4x4xf32>
+float matrix[4][4] = {
+    { 1.0f },
+    { 0.0f, 1.0f },
+    { 0.0f, 0.0f, 1.0f },
+    { 0.0f, 0.0f, 0.0f, 1.0f },
+};
+
+// CHECK: hl.var "small"
+// CHECK:   hl.initlist
+// CHECK-NOT: hl.initlist.dense
+const int small[3] = { 1, 2, 3 };
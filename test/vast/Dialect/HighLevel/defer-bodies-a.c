@@ -0,0 +1,24 @@
+// RUN: %vast-front -vast-emit-mlir=hl -o %t.serial.mlir %s
+// RUN: %vast-front -vast-emit-mlir=hl -vast-defer-function-bodies -o %t.deferred.mlir %s
+// RUN: diff %t.serial.mlir %t.deferred.mlir
+// RUN: %file-check --input-file=%t.deferred.mlir %s
+
+int counter;
+
+// The body fills the prototype emitted at the forward declaration.
+// CHECK: hl.func @next
+// CHECK:   hl.globref "counter"
+int next(void);
+
+// CHECK: hl.func @use_next
+// CHECK:   hl.call @next
+int use_next(void) { return next() + counter; }
+
+int next(void) { return ++counter; }
+
+// CHECK: hl.var "late"
+int late = 3;
+
+// CHECK: hl.func @use_late
+// CHECK:   hl.globref "late"
+int use_late(void) { return late; }
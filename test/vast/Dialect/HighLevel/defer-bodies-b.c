@@ -0,0 +1,15 @@
+// RUN: %vast-front -vast-emit-mlir=hl -vast-defer-function-bodies -o %t.mlir %s
+// RUN: %file-check --input-file=%t.mlir %s -check-prefix=HELPER
+// RUN: %file-check --input-file=%t.mlir %s -check-prefix=USER
+
+// Bodies of static functions are deferred as well and get their internal
+// linkage back once emitted.
+// HELPER: hl.func @helper internal
+// HELPER-NOT: sym_visibility = "private"
+// HELPER: hl.const #core.integer<7>
+// HELPER: hl.return
+static int helper(void) { return 7; }
+
+// USER: hl.func @user
+// USER:   hl.call @helper
+int user(void) { return helper(); }
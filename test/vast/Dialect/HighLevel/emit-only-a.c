@@ -0,0 +1,29 @@
+// RUN: %vast-front -vast-emit-mlir=hl -vast-reachable-from=entry -o - %s | %file-check %s -check-prefix=REACH
+// RUN: %vast-front -vast-emit-mlir=hl "-vast-emit-only=entry;un.*" -o - %s | %file-check %s -check-prefix=ONLY
+// RUN: not %vast-front -vast-emit-mlir=hl "-vast-emit-only=un(" -o - %s 2>&1 | %file-check %s -check-prefix=INVALID
+
+static int leaf(int x) { return x + 1; }
+
+int middle(int x) { return leaf(x) * 2; }
+
+int entry(int x) { return middle(x); }
+
+int unused(int x) { return x; }
+
+// REACH: hl.func @leaf internal
+// REACH:   hl.return
+// REACH: hl.func @middle
+// REACH:   hl.call @leaf
+// REACH: hl.func @entry
+// REACH:   hl.call @middle
+// REACH: hl.func @unused {{.*}}attributes {sym_visibility = "private"}
+// REACH-NOT: hl.return
+
+// ONLY: hl.func @leaf {{.*}}attributes {sym_visibility = "private"}
+// ONLY: hl.func @middle {{.*}}attributes {sym_visibility = "private"}
+// ONLY: hl.func @entry
+// ONLY:   hl.call @middle
+// ONLY: hl.func @unused
+// ONLY:   hl.return
+
+// INVALID: error: invalid -vast-emit-only pattern 'un(': parentheses not balanced
@@ -0,0 +1,23 @@
+// RUN: %vast-front -vast-emit-mlir=hl -vast-materialize=entry -o - %s | %file-check %s
+// RUN: %vast-front -vast-emit-mlir=hl -vast-materialize=missing -o %t.mlir %s 2>&1 | %file-check %s -check-prefix=MISSING
+
+static int leaf(int x) { return x + 1; }
+
+int middle(int x) { return leaf(x) * 2; }
+
+int entry(int x) { return middle(x); }
+
+int unused(int x) { return x; }
+
+// Only the body of `entry` is emitted, the static `leaf` becomes an external
+// declaration like every other pending body.
+// CHECK: hl.func @leaf {{.*}}attributes {sym_visibility = "private"}
+// CHECK-NOT: hl.func @leaf
+// CHECK: hl.func @middle {{.*}}attributes {sym_visibility = "private"}
+// CHECK: hl.func @entry
+// CHECK:   hl.call @middle
+// CHECK:   hl.return
+// CHECK: hl.func @unused {{.*}}attributes {sym_visibility = "private"}
+// CHECK-NOT: hl.return
+
+// MISSING: warning: cannot materialize 'missing', no such function
@@ -0,0 +1,14 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types -vast-profile-ir 2> %t.txt | %file-check %s
+// RUN: %file-check --input-file=%t.txt %s -check-prefix=TABLE
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types -vast-profile-ir=json -o %t.mlir 2> %t.json
+// RUN: %file-check --input-file=%t.json %s -check-prefix=JSON
+
+// CHECK: hl.func @sum
+
+// TABLE: pass {{ +}}runs {{ +}}time [s] {{ +}}ops {{ +}}blocks {{ +}}regions {{ +}}attributes {{ +}}types
+// TABLE-NEXT: vast-hl-lower-types {{ +}}1
+
+// JSON: "pass": "vast-hl-lower-types"
+// JSON: "runs": 1
+
+int sum(int a, int b) { return a + b; }
@@ -0,0 +1,65 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-fold | %file-check %s
+
+// CHECK-LABEL: hl.func @arith
+// CHECK-NOT: hl.add
+// CHECK-NOT: hl.mul
+// CHECK: [[C:%[0-9]+]] = hl.const #core.integer<14> : !hl.int
+// CHECK: hl.return [[C]]
+int arith(void) { return (3 + 4) * 2; }
+
+// CHECK-LABEL: hl.func @unsigned_wrap
+// CHECK: hl.const #core.integer<4294967295> : !hl.int< unsigned >
+// CHECK-NOT: hl.sub
+unsigned unsigned_wrap(void) { return 0u - 1u; }
+
+// CHECK-LABEL: hl.func @signed_overflow
+// CHECK: hl.add
+int signed_overflow(void) { return 2147483647 + 1; }
+
+// CHECK-LABEL: hl.func @div_by_zero
+// CHECK: hl.sdiv
+int div_by_zero(void) { return 1 / 0; }
+
+// CHECK-LABEL: hl.func @shift_out_of_range
+// CHECK: hl.bin.shl
+int shift_out_of_range(void) { return 1 << 32; }
+
+// CHECK-LABEL: hl.func @narrowing
+// CHECK-NOT: hl.implicit_cast
+// CHECK: hl.const #core.integer<44> : !hl.char
+char narrowing(void) { return 300; }
+
+// CHECK-LABEL: hl.func @compare
+// CHECK-NOT: hl.cmp
+// CHECK: hl.const #core.integer<1> : !hl.int
+int compare(void) { return 2 < 3; }
+
+// CHECK-LABEL: hl.func @identity
+// CHECK-NOT: hl.add
+// CHECK-NOT: hl.mul
+// CHECK: hl.return
+int identity(int a) { return (a + 0) * 1; }
+
+// CHECK-LABEL: hl.func @negated_cmp
+// CHECK-NOT: hl.lnot
+// CHECK: hl.cmp sge
+int negated_cmp(int a, int b) { return !(a < b); }
+
+// CHECK-LABEL: hl.func @unsigned_widening
+// CHECK-NOT: hl.cstyle_cast
+// CHECK: hl.const #core.integer<4294967295> : !hl.long< unsigned >
+unsigned long unsigned_widening(void) { return (unsigned long)0xFFFFFFFFu; }
+
+// CHECK-LABEL: hl.func @signed_widening
+// CHECK: hl.const #core.integer<-1> : !hl.long
+long signed_widening(void) { return (long)-1; }
+
+// CHECK-LABEL: hl.func @unsigned_to_float
+// CHECK-NOT: hl.cstyle_cast
+// CHECK: hl.const #core.float<4.000000e+09> : !hl.double
+double unsigned_to_float(void) { return (double)4000000000u; }
+
+// CHECK-LABEL: hl.func @signed_to_float
+// CHECK-NOT: hl.implicit_cast
+// CHECK: hl.const #core.float<-2.000000e+00> : !hl.float
+float signed_to_float(void) { return -2; }
@@ -0,0 +1,78 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-instrument-profile | %file-check %s
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-instrument-profile --vast-hl-instrument-profile | %file-check %s -check-prefix=TWICE
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-instrument-profile --vast-hl-symbol-dce | %file-check %s -check-prefix=DCE
+
+// CHECK: hl.var "__vast_prof_counters" sc_static : !hl.lvalue<!hl.array<11, ui64>> = {
+// CHECK:   hl.initlist.dense dense<0> : tensor<11xi64>
+// CHECK: hl.var "__vast_prof_keys" sc_static
+// CHECK: hl.func @__vast_prof_inc (!hl.ptr<ui64>, ui32) -> !hl.void attributes {sym_visibility = "private"}
+// CHECK: hl.func @__vast_prof_register (!hl.ptr<ui64>, !hl.ptr<si8>, ui32) -> !hl.void attributes {sym_visibility = "private"}
+// CHECK: hl.func @__vast_prof_init internal () -> !hl.void {
+// CHECK:   hl.const #core.integer<11> : ui32
+// CHECK:   hl.call @__vast_prof_register
+
+// DCE: hl.var "__vast_prof_counters"
+// DCE: hl.func @__vast_prof_init internal
+
+// TWICE: hl.var "__vast_prof_counters"
+// TWICE-NOT: hl.var "__vast_prof_counters"
+
+// CHECK-LABEL: hl.func @branches
+// CHECK:   hl.const #core.integer<0> : ui32
+// CHECK:   hl.call @__vast_prof_inc
+// CHECK:   hl.if
+// CHECK:   } then {
+// CHECK:     hl.const #core.integer<1> : ui32
+// CHECK:     hl.call @__vast_prof_inc
+// CHECK:   } else {
+// CHECK-NOT: hl.call @__vast_prof_inc
+// CHECK:   hl.return
+int branches(int a) {
+    if (a)
+        return 1;
+    else
+        return 2;
+}
+
+// CHECK-LABEL: hl.func @loops
+// CHECK:   hl.call @__vast_prof_inc
+// CHECK:   hl.while
+// CHECK-NOT: hl.call
+// CHECK:   } do {
+// CHECK:     hl.const #core.integer<3> : ui32
+// CHECK:     hl.call @__vast_prof_inc
+// CHECK:   hl.for
+// CHECK:   } do {
+// CHECK:     hl.const #core.integer<4> : ui32
+// CHECK:     hl.call @__vast_prof_inc
+void loops(int n) {
+    while (n)
+        --n;
+    for (int i = 0; i < n; ++i) {}
+}
+
+// CHECK-LABEL: hl.func @cases
+// CHECK:   hl.switch
+// CHECK:     hl.case
+// CHECK:       hl.const #core.integer<6> : ui32
+// CHECK:       hl.call @__vast_prof_inc
+// CHECK:     hl.default {
+// CHECK:       hl.const #core.integer<7> : ui32
+// CHECK:       hl.call @__vast_prof_inc
+int cases(int a) {
+    switch (a) {
+        case 1: return 1;
+        default: return 0;
+    }
+}
+
+// CHECK-LABEL: hl.func @jumps
+// CHECK:   hl.label
+// CHECK:     hl.const #core.integer<9> : ui32
+// CHECK:     hl.call @__vast_prof_inc
+int jumps(int a) {
+again:
+    if (a--)
+        goto again;
+    return a;
+}
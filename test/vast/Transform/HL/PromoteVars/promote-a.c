@@ -0,0 +1,67 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-promote-vars | %file-check %s
+
+int use(int);
+
+// CHECK-LABEL: hl.func @straight
+// CHECK-NOT: hl.var
+// CHECK: [[C:%[0-9]+]] = hl.const #core.integer<1>
+// CHECK: hl.call @use([[C]])
+// CHECK: [[A:%[0-9]+]] = hl.add
+// CHECK: hl.return [[A]]
+int straight(int a)
+{
+    int x = 1;
+    int y;
+    use(x);
+    y = x + a;
+    return y;
+}
+
+// CHECK-LABEL: hl.func @loop_invariant
+// CHECK-NOT: hl.var "n"
+// CHECK: hl.var "i"
+int loop_invariant(int a)
+{
+    int n = a * 2;
+    int s = 0;
+    for (int i = 0; i < n; ++i)
+        use(i);
+    return n;
+}
+
+// CHECK-LABEL: hl.func @stored_in_loop
+// CHECK: hl.var "s"
+int stored_in_loop(int a)
+{
+    int s = 0;
+    while (a--)
+        s = s + a;
+    return s;
+}
+
+// CHECK-LABEL: hl.func @stored_in_branch
+// CHECK: hl.var "s"
+int stored_in_branch(int a)
+{
+    int s = 0;
+    if (a)
+        s = a;
+    return s;
+}
+
+// CHECK-LABEL: hl.func @address_taken
+// CHECK: hl.var "x"
+int address_taken(void)
+{
+    int x = 0;
+    int *p = &x;
+    return *p;
+}
+
+// CHECK-LABEL: hl.func @volatile_var
+// CHECK: hl.var "v"
+int volatile_var(void)
+{
+    volatile int v = 0;
+    return v;
+}
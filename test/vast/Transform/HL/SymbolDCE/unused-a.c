@@ -0,0 +1,37 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-symbol-dce | %file-check %s --implicit-check-not=unused_ --implicit-check-not=UNUSED_
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-symbol-dce="roots=unused_helper" | %file-check %s -check-prefix=ROOTS
+
+struct unused_struct { int a; };
+typedef struct unused_struct unused_t;
+enum unused_enum { UNUSED_A, UNUSED_B };
+
+struct used_struct { int b; };
+typedef struct used_struct used_t;
+enum used_enum { USED_A, USED_B };
+
+static int unused_global;
+extern int unused_extern;
+static int used_global;
+int tentative;
+
+int extern_decl(int);
+int unused_decl(int);
+
+static inline int unused_helper(unused_t *p) { return p->a; }
+static inline int used_helper(used_t *p) { return p->b + used_global + extern_decl(USED_B); }
+
+int entry(used_t *p) { return used_helper(p); }
+
+
+// CHECK-DAG: hl.struct "used_struct"
+// CHECK-DAG: hl.typedef "used_t"
+// CHECK-DAG: hl.enum "used_enum"
+// CHECK-DAG: hl.var "used_global"
+// CHECK-DAG: hl.var "tentative"
+// CHECK-DAG: hl.func @extern_decl
+// CHECK-DAG: hl.func @used_helper
+// CHECK-DAG: hl.func @entry
+
+// ROOTS-DAG: hl.struct "unused_struct"
+// ROOTS-DAG: hl.typedef "unused_t"
+// ROOTS-DAG: hl.func @unused_helper
@@ -0,0 +1,90 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#include "generators.hpp"
+
+#include <iterator>
+
+namespace vast::bench
+{
+    namespace
+    {
+        std::string num(std::size_t value) { return std::to_string(value); }
+
+        const char *field_type(std::size_t idx) {
+            static constexpr const char *types[] = {
+                "char", "short", "int", "long", "unsigned", "float", "double"
+            };
+            return types[idx % std::size(types)];
+        }
+    } // namespace
+
+    std::string small_functions(std::size_t size) {
+        std::string src = "int f0(int x) { return x; }\n";
+        for (std::size_t i = 1; i < size; ++i) {
+            src += "int f" + num(i) + "(int x) { return f" + num(i - 1) + "(x) + " + num(i) + "; }\n";
+        }
+        return src;
+    }
+
+    std::string deep_nesting(std::size_t size) {
+        std::string src = "int nested(int x) {\n    int acc = 0;\n";
+        for (std::size_t i = 0; i < size; ++i) {
+            src += i % 2
+                ? "    while (x > " + num(i) + ") { --x;\n"
+                : "    if (x > " + num(i) + ") { acc += x;\n";
+        }
+        src += "    acc *= 2;\n";
+        for (std::size_t i = 0; i < size; ++i) {
+            src += "    }\n";
+        }
+        return src + "    return acc;\n}\n";
+    }
+
+    std::string giant_switch(std::size_t size) {
+        std::string src = "int dispatch(int x) {\n    switch (x) {\n";
+        for (std::size_t i = 0; i < size; ++i) {
+            src += "        case " + num(i) + ": return x * " + num(i) + ";\n";
+        }
+        return src + "        default: return -1;\n    }\n}\n";
+    }
+
+    std::string large_struct(std::size_t size) {
+        std::string src = "struct big {\n";
+        for (std::size_t i = 0; i < size; ++i) {
+            src += std::string("    ") + field_type(i) + " f" + num(i) + ";\n";
+        }
+        src += "};\n\nstruct big global = { ";
+        for (std::size_t i = 0; i < size; ++i) {
+            src += num(i) + ", ";
+        }
+        src += "};\n\nlong sum(struct big *b) {\n    long acc = 0;\n";
+        for (std::size_t i = 0; i < size; ++i) {
+            src += "    acc += b->f" + num(i) + ";\n";
+        }
+        return src + "    return acc;\n}\n";
+    }
+
+    std::string pointer_chasing(std::size_t size) {
+        std::string chain = "n";
+        for (std::size_t i = 0; i < size; ++i) {
+            chain += "->next";
+        }
+
+        return "struct node { struct node *next; int value; };\n\n"
+               "int chase(struct node *n) {\n"
+               "    " + chain + "->value = 1;\n"
+               "    return " + chain + "->value + (*" + chain + ").value;\n"
+               "}\n";
+    }
+
+    std::string macro_chain(std::size_t size) {
+        // Unparenthesized, so that the expansion does not hit the bracket
+        // depth limit of clang.
+        std::string src = "#define C0 1\n";
+        for (std::size_t i = 1; i < size; ++i) {
+            src += "#define C" + num(i) + " C" + num(i - 1) + " + " + num(i) + "\n";
+        }
+        return src + "\nlong value(void) { return C" + num(size - 1) + "; }\n";
+    }
+
+} // namespace vast::bench
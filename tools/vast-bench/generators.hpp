@@ -0,0 +1,31 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace vast::bench
+{
+    // Generators of synthetic C translation units. Each one stresses a single
+    // shape of input, `size` scales the amount of the generated code.
+
+    // Many small functions calling their predecessor.
+    std::string small_functions(std::size_t size);
+
+    // A single function with `size` levels of nested control flow.
+    std::string deep_nesting(std::size_t size);
+
+    // A single switch statement with `size` cases.
+    std::string giant_switch(std::size_t size);
+
+    // A struct with `size` fields and a global initialized by an init list.
+    std::string large_struct(std::size_t size);
+
+    // A linked structure traversed by expressions `size` dereferences deep.
+    std::string pointer_chasing(std::size_t size);
+
+    // A constant defined by a chain of `size` macro expansions.
+    std::string macro_chain(std::size_t size);
+
+} // namespace vast::bench
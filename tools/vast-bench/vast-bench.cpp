@@ -0,0 +1,265 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+// Microbenchmarks of codegen and conversion hot paths on synthetic inputs.
+// Results are printed as JSON unless `--benchmark_format` says otherwise.
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <benchmark/benchmark.h>
+
+#include <clang/AST/RecursiveASTVisitor.h>
+#include <clang/Basic/CodeGenOptions.h>
+#include <clang/Frontend/ASTUnit.h>
+#include <clang/Frontend/FrontendOptions.h>
+#include <clang/Tooling/Tooling.h>
+
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <mlir/IR/BuiltinOps.h>
+#include <mlir/Pass/PassInstrumentation.h>
+#include <mlir/Pass/PassManager.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/CodeGen/CodeGen.hpp"
+#include "vast/CodeGen/CodeGenContext.hpp"
+#include "vast/CodeGen/CodeGenDriver.hpp"
+#include "vast/Target/LLVMIR/Convert.hpp"
+#include "vast/Util/Common.hpp"
+
+#include "generators.hpp"
+
+#include <chrono>
+#include <map>
+
+namespace vast::bench
+{
+    struct input_t {
+        const char *name;
+        std::string (*generate)(std::size_t);
+        std::size_t size;
+    };
+
+    constexpr input_t inputs[] = {
+        { "small_functions", small_functions, 2000 },
+        { "deep_nesting",    deep_nesting,    200  },
+        { "giant_switch",    giant_switch,    4000 },
+        { "large_struct",    large_struct,    1000 },
+        { "pointer_chasing", pointer_chasing, 500  },
+        { "macro_chain",     macro_chain,     1000 },
+    };
+
+    // Parsed input together with the options the codegen driver refers to.
+    struct unit_t {
+        std::unique_ptr< clang::ASTUnit > ast;
+        clang::CodeGenOptions codegen = {};
+        clang::FrontendOptions front  = {};
+
+        acontext_t &actx() { return ast->getASTContext(); }
+
+        cc::action_options options() {
+            return {
+                .headers = ast->getHeaderSearchOpts(),
+                .codegen = codegen,
+                .target  = actx().getTargetInfo().getTargetOpts(),
+                .lang    = actx().getLangOpts(),
+                .front   = front,
+                .diags   = ast->getDiagnostics(),
+                .vfs     = ast->getFileManager().getVirtualFileSystem()
+            };
+        }
+    };
+
+    // Inputs are parsed once per process, benchmarks run repeatedly.
+    unit_t &get_unit(const input_t &input, std::size_t size) {
+        static std::map< std::pair< std::string, std::size_t >, unit_t > units;
+
+        auto [it, inserted] = units.try_emplace({ input.name, size });
+        if (inserted) {
+            it->second.ast = clang::tooling::buildASTFromCodeWithArgs(
+                input.generate(size), { "-std=c17" }, "bench.c"
+            );
+            VAST_CHECK(it->second.ast, "cannot parse generated input {0}", input.name);
+        }
+
+        return it->second;
+    }
+
+    struct node_counter : clang::RecursiveASTVisitor< node_counter > {
+        std::size_t nodes = 0;
+
+        bool VisitDecl(clang::Decl *) { return ++nodes, true; }
+        bool VisitStmt(clang::Stmt *) { return ++nodes, true; }
+    };
+
+    struct type_collector : clang::RecursiveASTVisitor< type_collector > {
+        std::vector< clang::QualType > types;
+
+        bool VisitValueDecl(clang::ValueDecl *decl) { return types.push_back(decl->getType()), true; }
+        bool VisitExpr(clang::Expr *expr) { return types.push_back(expr->getType()), true; }
+    };
+
+    owning_module_ref emit_hl(unit_t &unit, mcontext_t &mctx) {
+        auto opts = unit.options();
+        cg::codegen_context cgctx(mctx, unit.actx(), cg::source_language::C);
+        cg::codegen_driver driver(cgctx, opts);
+
+        for (auto decl : unit.actx().getTranslationUnitDecl()->decls()) {
+            driver.handle_top_level_decl(clang::DeclGroupRef(decl));
+        }
+
+        driver.handle_translation_unit(unit.actx());
+        return std::move(cgctx.mod);
+    }
+
+    void bench_codegen(benchmark::State &state, const input_t &input) {
+        auto &unit = get_unit(input, state.range(0));
+
+        node_counter counter;
+        counter.TraverseAST(unit.actx());
+
+        mcontext_t mctx;
+        for (auto _ : state) {
+            auto mod = emit_hl(unit, mctx);
+            benchmark::DoNotOptimize(mod.get());
+        }
+
+        state.counters["nodes"] = benchmark::Counter(
+            static_cast< double >(counter.nodes), benchmark::Counter::kIsIterationInvariantRate
+        );
+    }
+
+    void bench_types(benchmark::State &state, const input_t &input) {
+        auto &unit = get_unit(input, state.range(0));
+
+        type_collector collector;
+        collector.TraverseAST(unit.actx());
+
+        mcontext_t mctx;
+        cg::codegen_context cgctx(mctx, unit.actx(), cg::source_language::C);
+        cg::default_codegen codegen(cgctx);
+
+        for (auto _ : state) {
+            for (auto type : collector.types) {
+                benchmark::DoNotOptimize(codegen.convert(type));
+            }
+        }
+
+        state.counters["types"] = benchmark::Counter(
+            static_cast< double >(collector.types.size()), benchmark::Counter::kIsIterationInvariantRate
+        );
+    }
+
+    // Accumulates the time spent in each pass. Pass adaptors have no
+    // argument and are skipped, their time is attributed to nested passes.
+    struct pass_timer final : mlir::PassInstrumentation {
+        using clock = std::chrono::steady_clock;
+
+        explicit pass_timer(std::map< std::string, double > &totals) : totals(totals) {}
+
+        void runBeforePass(mlir::Pass *pass, operation) override {
+            started[pass] = clock::now();
+        }
+
+        void runAfterPass(mlir::Pass *pass, operation) override { record(pass); }
+        void runAfterPassFailed(mlir::Pass *pass, operation) override { record(pass); }
+
+        void record(mlir::Pass *pass) {
+            if (auto arg = pass->getArgument(); !arg.empty()) {
+                std::chrono::duration< double > elapsed = clock::now() - started[pass];
+                totals[arg.str()] += elapsed.count();
+            }
+        }
+
+        std::map< std::string, double > &totals;
+        llvm::DenseMap< mlir::Pass *, clock::time_point > started;
+    };
+
+    void bench_passes(benchmark::State &state, const input_t &input) {
+        auto &unit = get_unit(input, state.range(0));
+
+        mcontext_t mctx;
+        // Passes then run one at a time and their times do not overlap.
+        mctx.disableMultithreading();
+        auto hl = emit_hl(unit, mctx);
+        target::llvmir::register_vast_to_llvm_ir(mctx);
+
+        std::map< std::string, double > totals;
+        auto instrument = [&] (mlir::PassManager &pm) {
+            pm.addInstrumentation(std::make_unique< pass_timer >(totals));
+        };
+
+        for (auto _ : state) {
+            state.PauseTiming();
+            owning_module_ref mod(hl->clone());
+            state.ResumeTiming();
+
+            target::llvmir::lower_hl_module(mod.get(), target::llvmir::default_pipeline(), instrument);
+        }
+
+        for (const auto &[pass, seconds] : totals) {
+            state.counters["pass:" + pass] = benchmark::Counter(seconds, benchmark::Counter::kAvgIterations);
+        }
+    }
+
+    void bench_translate(benchmark::State &state, const input_t &input) {
+        auto &unit = get_unit(input, state.range(0));
+
+        mcontext_t mctx;
+        auto mod = emit_hl(unit, mctx);
+        target::llvmir::register_vast_to_llvm_ir(mctx);
+        target::llvmir::lower_hl_module(mod.get());
+
+        for (auto _ : state) {
+            llvm::LLVMContext llvm_ctx;
+            auto llvm_mod = target::llvmir::translate(mod.get(), llvm_ctx);
+            benchmark::DoNotOptimize(llvm_mod.get());
+        }
+    }
+
+    void register_benchmarks() {
+        using bench_fn = void (*)(benchmark::State &, const input_t &);
+
+        constexpr std::pair< const char *, bench_fn > benchmarks[] = {
+            { "codegen",   bench_codegen   },
+            { "types",     bench_types     },
+            { "passes",    bench_passes    },
+            { "translate", bench_translate },
+        };
+
+        for (const auto &[kind, fn] : benchmarks) {
+            for (const auto &input : inputs) {
+                auto name = std::string(kind) + "/" + input.name;
+                benchmark::RegisterBenchmark(name.c_str(), fn, input)
+                    ->Arg(static_cast< int64_t >(input.size))
+                    ->Unit(benchmark::kMillisecond);
+            }
+        }
+    }
+
+} // namespace vast::bench
+
+int main(int argc, char **argv) {
+    vast::bench::register_benchmarks();
+
+    std::vector< char * > args(argv, argv + argc);
+    std::string json = "--benchmark_format=json";
+    auto has_format = llvm::any_of(args, [] (llvm::StringRef arg) {
+        return arg.startswith("--benchmark_format");
+    });
+
+    if (!has_format) {
+        args.insert(std::next(args.begin()), json.data());
+    }
+
+    int count = static_cast< int >(args.size());
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
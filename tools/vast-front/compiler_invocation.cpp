@@ -40,6 +40,7 @@ namespace vast::cc
 
         switch (act) {
             case ASTDump:  return std::make_unique< clang::ASTDumpAction >();
+            case ParseSyntaxOnly: return std::make_unique< clang::SyntaxOnlyAction >();
             case EmitAssembly: return std::make_unique< vast::cc::emit_assembly_action >(vargs);
             case EmitLLVM: return std::make_unique< vast::cc::emit_llvm_action >(vargs);
             case EmitObj: return std::make_unique< vast::cc::emit_obj_action >(vargs);
@@ -12,8 +12,10 @@ VAST_RELAX_WARNINGS
 #include "mlir/Support/FileUtilities.h"
 #include "mlir/Target/LLVMIR/Dialect/All.h"
 #include "mlir/Tools/mlir-opt/MlirOptMain.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/Process.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/ToolOutputFile.h"
 VAST_UNRELAX_WARNINGS
@@ -23,9 +25,20 @@ VAST_UNRELAX_WARNINGS
 #include "vast/Dialect/HighLevel/Passes.hpp"
 #include "vast/Conversion/Passes.hpp"
 #include "vast/Dialect/Dialects.hpp"
+#include "vast/Util/IRProfile.hpp"
 
+static llvm::cl::opt< std::string > profile_ir(
+    "vast-profile-ir",
+    llvm::cl::desc("Print size of the IR and time of each pass, as a `table` or `json`"),
+    llvm::cl::ValueOptional, llvm::cl::init("")
+);
+
+// Mirrors `mlir::MlirOptMain(argc, argv, ...)`, which offers no way to set
+// up the pass pipeline of its config.
 int main(int argc, char **argv)
 {
+    llvm::InitLLVM init_llvm(argc, argv);
+
     mlir::registerAllPasses();
     // Register VAST passes here
     vast::hl::registerHighLevelPasses();
@@ -39,7 +52,66 @@ int main(int argc, char **argv)
     // register conversions
     mlir::registerAllToLLVMIRTranslations(registry);
 
-    return failed(
-        mlir::MlirOptMain(argc, argv, "VAST Optimizer driver\n", registry)
+    auto [input, output] = mlir::registerAndParseCLIOptions(
+        argc, argv, "VAST Optimizer driver\n", registry
     );
+
+    auto config = mlir::MlirOptMainConfig::createFromCLOptions();
+
+    if (config.shouldShowDialects()) {
+        llvm::outs() << "Available Dialects: ";
+        llvm::interleave(registry.getDialectNames(), llvm::outs(), ",");
+        llvm::outs() << "\n";
+        return EXIT_SUCCESS;
+    }
+
+    // `-vast-profile-ir` without a value is reported as a table.
+    vast::ir_profile profile;
+    std::optional< vast::ir_profile_format > profile_format;
+    if (profile_ir.getNumOccurrences()) {
+        profile_format = profile_ir.empty()
+            ? vast::ir_profile_format::table
+            : vast::parse_ir_profile_format(profile_ir);
+        if (!profile_format) {
+            llvm::errs() << "unknown format of IR profile: " << profile_ir << "\n";
+            return EXIT_FAILURE;
+        }
+
+        // Keep the pipeline given on the command line and profile it.
+        config.setPassPipelineSetupFn([&, cli = config] (mlir::PassManager &pm) {
+            if (mlir::failed(cli.setupPassPipeline(pm))) {
+                return mlir::failure();
+            }
+            profile.attach(pm);
+            return mlir::success();
+        });
+    }
+
+    if (input == "-" && llvm::sys::Process::FileDescriptorIsDisplayed(fileno(stdin))) {
+        llvm::errs() << "(processing input from stdin now, hit ctrl-c/ctrl-d to interrupt)\n";
+    }
+
+    std::string error;
+    auto file = mlir::openInputFile(input, &error);
+    if (!file) {
+        llvm::errs() << error << "\n";
+        return EXIT_FAILURE;
+    }
+
+    auto out = mlir::openOutputFile(output, &error);
+    if (!out) {
+        llvm::errs() << error << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if (mlir::failed(mlir::MlirOptMain(out->os(), std::move(file), registry, config))) {
+        return EXIT_FAILURE;
+    }
+
+    if (profile_format) {
+        profile.print(llvm::errs(), *profile_format);
+    }
+
+    out->keep();
+    return EXIT_SUCCESS;
 }
@@ -132,6 +132,10 @@ namespace vast::repl::cmd {
         llvm::StringRef(pipeline).split(passes, ',');
 
         mlir::PassManager pm(&state.ctx);
+        if (state.profile) {
+            state.profile->attach(pm);
+        }
+
         auto th = state.tower->top();
         for (auto pass : passes) {
             if (mlir::failed(mlir::parsePassPipeline(pass, pm))) {
@@ -141,4 +145,26 @@ namespace vast::repl::cmd {
         }
     }
 
+    //
+    // profile command
+    //
+    void profile::run(state_t &state) const {
+        auto action = get_param< action_param >(params);
+        if (action == profile_action::start) {
+            state.profile.emplace();
+            return;
+        }
+
+        if (!state.profile) {
+            VAST_UNREACHABLE("error: profiling was not started");
+        }
+
+        switch (action) {
+            case profile_action::stop:  state.profile.reset(); break;
+            case profile_action::table: state.profile->print_table(llvm::outs()); break;
+            case profile_action::json:  state.profile->print_json(llvm::outs()); break;
+            case profile_action::start: break;
+        }
+    }
+
 } // namespace vast::repl::cmd
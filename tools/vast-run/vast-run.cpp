@@ -0,0 +1,357 @@
+// Copyright (c) 2023-present, Trail of Bits, Inc.
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include "mlir/ExecutionEngine/ExecutionEngine.h"
+#include "mlir/ExecutionEngine/OptUtils.h"
+#include "mlir/IR/Dialect.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/InitAllDialects.h"
+#include "mlir/Parser/Parser.h"
+#include "mlir/Support/FileUtilities.h"
+
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/xxhash.h"
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/Core/CoreDialect.hpp"
+#include "vast/Dialect/Dialects.hpp"
+#include "vast/Target/LLVMIR/Convert.hpp"
+#include "vast/Util/Common.hpp"
+
+#include <cstdlib>
+
+using memory_buffer = std::unique_ptr< llvm::MemoryBuffer >;
+
+namespace vast::cl
+{
+    namespace cl = llvm::cl;
+
+    cl::OptionCategory generic("Vast Generic Options");
+    cl::OptionCategory jit("Vast JIT Options");
+
+    // clang-format off
+    struct vast_run_options {
+        cl::opt< std::string > input_file{
+            cl::desc("<input module>"),
+            cl::Positional,
+            cl::Required,
+            cl::cat(generic)
+        };
+        cl::list< std::string > program_args{
+            cl::desc("<program arguments>..."),
+            cl::ConsumeAfter,
+            cl::cat(generic)
+        };
+        cl::list< std::string > extra_modules{ "extra-module",
+            cl::desc("Extra modules to be linked with the input module"),
+            cl::value_desc("module"),
+            cl::cat(generic)
+        };
+        cl::opt< std::string > entry_point{ "entry-point",
+            cl::desc("Function to be called"),
+            cl::value_desc("name"),
+            cl::init("main"),
+            cl::cat(jit)
+        };
+        cl::opt< unsigned > opt_level{ "O",
+            cl::desc("Optimization level of MLIR pipelines and the JIT compiler"),
+            cl::Prefix,
+            cl::init(0),
+            cl::cat(jit)
+        };
+        cl::opt< std::string > cache_dir{ "cache-dir",
+            cl::desc("Directory to cache compiled objects in"),
+            cl::value_desc("directory"),
+            cl::init(""),
+            cl::cat(jit)
+        };
+        cl::list< std::string > shared_libs{ "shared-libs",
+            cl::desc("Libraries to be loaded to resolve external symbols"),
+            cl::value_desc("library"),
+            cl::CommaSeparated,
+            cl::cat(jit)
+        };
+    };
+    // clang-format on
+
+    static llvm::ManagedStatic< vast_run_options > options;
+
+    void register_options() { *options; }
+} // namespace vast::cl
+
+namespace vast::run
+{
+    namespace orc = llvm::orc;
+
+    // Persistent cache of compiled modules. Modules are identified by the
+    // hash of their source and the compilation settings, so an unchanged
+    // module is loaded from the cache without being lowered or compiled.
+    struct object_cache final : llvm::ObjectCache
+    {
+        explicit object_cache(std::string dir) : dir(std::move(dir)) {}
+
+        bool enabled() const { return !dir.empty(); }
+
+        std::string path(string_ref key) const {
+            llvm::SmallString< 128 > path(dir);
+            llvm::sys::path::append(path, key + ".o");
+            return path.str().str();
+        }
+
+        memory_buffer load(string_ref key) const {
+            if (!enabled())
+                return nullptr;
+            auto buffer = llvm::MemoryBuffer::getFile(path(key));
+            return buffer ? std::move(*buffer) : nullptr;
+        }
+
+        void notifyObjectCompiled(const llvm::Module *mod, llvm::MemoryBufferRef obj) override {
+            if (!enabled())
+                return;
+
+            if (auto ec = llvm::sys::fs::create_directories(dir)) {
+                llvm::errs() << "warning: cannot create cache directory: " << ec.message() << "\n";
+                return;
+            }
+
+            // Write to a temporary file first, so that concurrent runs never
+            // see a partially written object.
+            auto target = path(mod->getModuleIdentifier());
+            auto temp   = target + ".tmp";
+            {
+                std::error_code ec;
+                llvm::raw_fd_ostream os(temp, ec, llvm::sys::fs::OF_None);
+                if (ec) {
+                    llvm::errs() << "warning: cannot write cached object: " << ec.message() << "\n";
+                    return;
+                }
+                os << obj.getBuffer();
+            }
+
+            if (auto ec = llvm::sys::fs::rename(temp, target))
+                llvm::errs() << "warning: cannot write cached object: " << ec.message() << "\n";
+        }
+
+        memory_buffer getObject(const llvm::Module *mod) override {
+            return load(mod->getModuleIdentifier());
+        }
+
+      private:
+        std::string dir;
+    };
+
+    std::string module_key(string_ref source, string_ref triple, unsigned opt_level) {
+        auto hash = llvm::xxh3_64bits(llvm::arrayRefFromStringRef(source));
+        hash = llvm::xxh3_64bits(llvm::arrayRefFromStringRef(triple)) ^ (hash * 31);
+        return llvm::formatv("{0:x16}-O{1}", hash, opt_level).str();
+    }
+
+    struct jit_session
+    {
+        mcontext_t &mctx;
+        unsigned opt_level;
+
+        object_cache cache;
+        std::unique_ptr< orc::LLJIT > jit = nullptr;
+        std::unique_ptr< llvm::TargetMachine > tm = nullptr;
+
+        jit_session(mcontext_t &mctx, unsigned opt_level, std::string cache_dir)
+            : mctx(mctx), opt_level(opt_level), cache(std::move(cache_dir))
+        {}
+
+        static llvm::CodeGenOpt::Level codegen_opt_level(unsigned level) {
+            switch (level) {
+                case 0:  return llvm::CodeGenOpt::None;
+                case 1:  return llvm::CodeGenOpt::Less;
+                case 2:  return llvm::CodeGenOpt::Default;
+                default: return llvm::CodeGenOpt::Aggressive;
+            }
+        }
+
+        // Mirrors the setup of `mlir::ExecutionEngine`, which does not allow
+        // to plug in a persistent object cache.
+        llvm::Error initialize(llvm::ArrayRef< std::string > shared_libs) {
+            auto jtmb = orc::JITTargetMachineBuilder::detectHost();
+            if (!jtmb)
+                return jtmb.takeError();
+            jtmb->setCodeGenOptLevel(codegen_opt_level(opt_level));
+
+            auto target_machine = jtmb->createTargetMachine();
+            if (!target_machine)
+                return target_machine.takeError();
+            tm = std::move(*target_machine);
+
+            auto compile_function_creator = [&] (orc::JITTargetMachineBuilder builder)
+                -> llvm::Expected< std::unique_ptr< orc::IRCompileLayer::IRCompiler > >
+            {
+                auto machine = builder.createTargetMachine();
+                if (!machine)
+                    return machine.takeError();
+                return std::make_unique< orc::TMOwningSimpleCompiler >(std::move(*machine), &cache);
+            };
+
+            auto built = orc::LLJITBuilder()
+                .setJITTargetMachineBuilder(std::move(*jtmb))
+                .setCompileFunctionCreator(compile_function_creator)
+                .create();
+            if (!built)
+                return built.takeError();
+            jit = std::move(*built);
+
+            auto &dylib = jit->getMainJITDylib();
+            auto prefix = jit->getDataLayout().getGlobalPrefix();
+
+            auto process = orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(prefix);
+            if (!process)
+                return process.takeError();
+            dylib.addGenerator(std::move(*process));
+
+            for (const auto &lib : shared_libs) {
+                auto generator = orc::DynamicLibrarySearchGenerator::Load(lib.c_str(), prefix);
+                if (!generator)
+                    return generator.takeError();
+                dylib.addGenerator(std::move(*generator));
+            }
+
+            return llvm::Error::success();
+        }
+
+        llvm::Error lower_and_add(memory_buffer buffer, std::string key) {
+            llvm::SourceMgr source_mgr;
+            source_mgr.AddNewSourceBuffer(std::move(buffer), llvm::SMLoc());
+            mlir::SourceMgrDiagnosticHandler handler(source_mgr, &mctx);
+
+            // Parses both textual and bytecode modules.
+            owning_module_ref mod(mlir::parseSourceFile< vast_module >(source_mgr, &mctx));
+            if (!mod)
+                return llvm::createStringError(llvm::inconvertibleErrorCode(), "cannot parse module");
+
+            if (opt_level > 0) {
+                mod.get()->setAttr(
+                    core::CoreDialect::getOptLevelAttrName(),
+                    mlir::IntegerAttr::get(mlir::IntegerType::get(&mctx, 32), opt_level)
+                );
+            }
+
+            target::llvmir::lower_hl_module(mod.get());
+
+            auto llvm_ctx = std::make_unique< llvm::LLVMContext >();
+            auto llvm_mod = target::llvmir::translate(mod.get(), *llvm_ctx);
+            if (!llvm_mod)
+                return llvm::createStringError(llvm::inconvertibleErrorCode(), "cannot translate module");
+
+            mlir::ExecutionEngine::setupTargetTripleAndDataLayout(llvm_mod.get(), tm.get());
+            auto optimize = mlir::makeOptimizingTransformer(opt_level, 0, tm.get());
+            if (auto err = optimize(llvm_mod.get()))
+                return err;
+
+            // The identifier is the key of the object in the cache.
+            llvm_mod->setModuleIdentifier(key);
+            return jit->addIRModule(orc::ThreadSafeModule(std::move(llvm_mod), std::move(llvm_ctx)));
+        }
+
+        llvm::Error add(const std::string &file) {
+            std::string err;
+            auto input = mlir::openInputFile(file, &err);
+            if (!input)
+                return llvm::createStringError(llvm::inconvertibleErrorCode(), err);
+
+            auto key = module_key(input->getBuffer(), tm->getTargetTriple().str(), opt_level);
+            if (auto cached = cache.load(key))
+                return jit->addObjectFile(std::move(cached));
+            return lower_and_add(std::move(input), std::move(key));
+        }
+
+        llvm::Expected< int > run_main(string_ref entry, const std::vector< std::string > &args) {
+            if (auto err = jit->initialize(jit->getMainJITDylib()))
+                return std::move(err);
+
+            auto symbol = jit->lookup(entry);
+            if (!symbol)
+                return symbol.takeError();
+
+            std::vector< char * > argv;
+            for (const auto &arg : args)
+                argv.push_back(const_cast< char * >(arg.c_str()));
+            argv.push_back(nullptr);
+
+            using main_t = int (*)(int, char **);
+            auto result = symbol->toPtr< main_t >()(static_cast< int >(args.size()), argv.data());
+
+            if (auto err = jit->deinitialize(jit->getMainJITDylib()))
+                return std::move(err);
+            return result;
+        }
+    };
+
+    int run(mcontext_t &mctx) {
+        const auto &opts = *cl::options;
+
+        auto report = [] (llvm::Error err) {
+            llvm::logAllUnhandledErrors(std::move(err), llvm::errs(), "error: ");
+            return EXIT_FAILURE;
+        };
+
+        jit_session session(mctx, opts.opt_level, opts.cache_dir);
+        if (auto err = session.initialize(opts.shared_libs))
+            return report(std::move(err));
+
+        if (auto err = session.add(opts.input_file))
+            return report(std::move(err));
+
+        for (const auto &file : opts.extra_modules) {
+            if (auto err = session.add(file))
+                return report(std::move(err));
+        }
+
+        std::vector< std::string > args = { opts.input_file };
+        args.insert(args.end(), opts.program_args.begin(), opts.program_args.end());
+
+        auto result = session.run_main(opts.entry_point, args);
+        if (!result)
+            return report(result.takeError());
+
+        // Exit right after the entry returns, as the C runtime does, so that
+        // atexit handlers of loaded libraries (e.g. the profiling runtime
+        // dumping its counters) run while the jitted code and data are mapped.
+        std::exit(*result);
+    }
+
+} // namespace vast::run
+
+int main(int argc, char **argv) {
+    llvm::InitLLVM init(argc, argv);
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+
+    llvm::cl::HideUnrelatedOptions({ &vast::cl::generic, &vast::cl::jit });
+    vast::cl::register_options();
+    llvm::cl::ParseCommandLineOptions(argc, argv, "VAST JIT runner\n");
+
+    mlir::DialectRegistry registry;
+    vast::registerAllDialects(registry);
+    mlir::registerAllDialects(registry);
+    vast::target::llvmir::register_vast_to_llvm_ir(registry);
+
+    vast::mcontext_t mctx(registry);
+    mctx.loadAllAvailableDialects();
+
+    return vast::run::run(mctx);
+}